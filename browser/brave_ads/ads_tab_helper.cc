@@ -8,6 +8,7 @@
 #include <memory>
 #include <utility>
 
+#include "base/metrics/histogram_macros.h"
 #include "brave/browser/brave_ads/ads_service_factory.h"
 #include "brave/components/brave_ads/browser/ads_service.h"
 #include "chrome/browser/profiles/profile.h"
@@ -78,8 +79,15 @@ void AdsTabHelper::RunIsolatedJavaScript(
     content::RenderFrameHost* render_frame_host) {
   DCHECK(render_frame_host);
 
+  // The ads library only looks for the ad-conversion-id meta tag in the HTML,
+  // so probe for that tag instead of serializing the whole document
   dom_distiller::RunIsolatedJavaScript(
-      render_frame_host, "new XMLSerializer().serializeToString(document)",
+      render_frame_host,
+      "(function() {"
+      "  const meta ="
+      "      document.querySelector('meta[name=\"ad-conversion-id\"]');"
+      "  return meta ? meta.outerHTML : '';"
+      "})()",
       base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
                      weak_factory_.GetWeakPtr()));
 
@@ -96,6 +104,8 @@ void AdsTabHelper::OnJavaScriptHtmlResult(base::Value value) {
   std::string html;
   value.GetAsString(&html);
 
+  UMA_HISTOGRAM_COUNTS_10M("Brave.Ads.PageLoad.HtmlBytes", html.size());
+
   ads_service_->OnHtmlLoaded(tab_id_, redirect_chain_, html);
 }
 
@@ -106,6 +116,8 @@ void AdsTabHelper::OnJavaScriptTextResult(base::Value value) {
   std::string text;
   value.GetAsString(&text);
 
+  UMA_HISTOGRAM_COUNTS_10M("Brave.Ads.PageLoad.TextBytes", text.size());
+
   ads_service_->OnTextLoaded(tab_id_, redirect_chain_, text);
 }
 
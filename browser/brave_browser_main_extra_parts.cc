@@ -76,3 +76,9 @@ void BraveBrowserMainExtraParts::PreMainMessageLoopRun() {
   brave::BraveUptimeTracker::CreateInstance(g_browser_process->local_state());
 #endif  // !defined(OS_ANDROID)
 }
+
+void BraveBrowserMainExtraParts::PostMainMessageLoopRun() {
+#if BUILDFLAG(BRAVE_P3A_ENABLED)
+  g_brave_browser_process->brave_p3a_service()->OnShutdown();
+#endif  // BUILDFLAG(BRAVE_P3A_ENABLED)
+}
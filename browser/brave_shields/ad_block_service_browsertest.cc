@@ -20,6 +20,7 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/brave_shields/common/features.h"
@@ -78,6 +79,9 @@ using content::BrowserThread;
 
 void AdBlockServiceTest::SetUpOnMainThread() {
   ExtensionBrowserTest::SetUpOnMainThread();
+  // Stats counters are checked right after the page reports a block.
+  brave_shields::BraveShieldsWebContentsObserver::
+      SetBlockedEventsFlushDelayForTesting(base::TimeDelta());
   host_resolver()->AddRule("*", "127.0.0.1");
 }
 
@@ -3,6 +3,11 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <atomic>
+
+#include "base/barrier_closure.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/path_service.h"
 #include "base/scoped_observer.h"
 #include "brave/browser/brave_wallet/brave_wallet_service_factory.h"
@@ -57,6 +62,18 @@ std::unique_ptr<net::test_server::HttpResponse> HandleRequestServerError(
   return std::move(http_response);
 }
 
+const char kTokenBalance[] =
+    "0x00000000000000000000000000000000000000000000000166e12cfce39a0000";
+
+void OnBalance(base::RepeatingClosure done_closure,
+               const std::string& expected_balance,
+               bool success,
+               const std::string& balance) {
+  EXPECT_TRUE(success);
+  EXPECT_EQ(expected_balance, balance);
+  done_closure.Run();
+}
+
 }  // namespace
 
 class EthJsonRpcBrowserTest : public InProcessBrowserTest {
@@ -76,6 +93,44 @@ class EthJsonRpcBrowserTest : public InProcessBrowserTest {
 
   ~EthJsonRpcBrowserTest() override {}
 
+  // Answers JSON-RPC batches like a provider, and counts the requests.
+  std::unique_ptr<net::test_server::HttpResponse> HandleBatchRequest(
+      const net::test_server::HttpRequest& request) {
+    request_count_++;
+
+    base::Optional<base::Value> batch = base::JSONReader::Read(request.content);
+    if (!batch || !batch->is_list())
+      return HandleRequest(request);
+
+    base::Value responses(base::Value::Type::LIST);
+    for (const auto& call : batch->GetList()) {
+      const std::string* method = call.FindStringKey("method");
+      base::Value response(base::Value::Type::DICTIONARY);
+      response.SetStringKey("jsonrpc", "2.0");
+      response.SetKey("id", call.FindKey("id")->Clone());
+      if (*method == "eth_call") {
+        response.SetStringKey("result", kTokenBalance);
+      } else if (*method == "eth_blockNumber") {
+        response.SetStringKey("result", "0x1");
+      } else {
+        response.SetStringKey("result", "0xb539d5");
+      }
+      responses.Append(std::move(response));
+    }
+
+    std::string content;
+    base::JSONWriter::Write(responses, &content);
+
+    std::unique_ptr<net::test_server::BasicHttpResponse> http_response(
+        new net::test_server::BasicHttpResponse());
+    http_response->set_code(net::HTTP_OK);
+    http_response->set_content_type("application/json");
+    http_response->set_content(content);
+    return std::move(http_response);
+  }
+
+  int request_count() const { return request_count_; }
+
   content::WebContents* contents() {
     return browser()->tab_strip_model()->GetActiveWebContents();
   }
@@ -153,6 +208,7 @@ class EthJsonRpcBrowserTest : public InProcessBrowserTest {
 
   std::unique_ptr<base::RunLoop> wait_for_request_;
   std::unique_ptr<net::EmbeddedTestServer> https_server_;
+  std::atomic<int> request_count_{0};
 };
 
 IN_PROC_BROWSER_TEST_F(EthJsonRpcBrowserTest, Request) {
@@ -215,3 +271,57 @@ IN_PROC_BROWSER_TEST_F(EthJsonRpcBrowserTest, GetERC20TokenBalance) {
       "0x00000000000000000000000000000000000000000000000166e12cfce39a0000",
       true);
 }
+
+IN_PROC_BROWSER_TEST_F(EthJsonRpcBrowserTest, BatchRequests) {
+  ResetHTTPSServer(
+      base::BindRepeating(&EthJsonRpcBrowserTest::HandleBatchRequest,
+                          base::Unretained(this)));
+  auto* controller = GetEthJsonRpcController();
+
+  base::RunLoop run_loop;
+  base::RepeatingClosure barrier =
+      base::BarrierClosure(3, run_loop.QuitClosure());
+  controller->GetBalance(
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, barrier, std::string("0xb539d5")));
+  controller->GetBalance(
+      "0x5e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, barrier, std::string("0xb539d5")));
+  controller->GetERC20TokenBalance(
+      "0x0d8775f648430679a709e98d2b0cb6250d2887ef",
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, barrier, std::string(kTokenBalance)));
+  run_loop.Run();
+
+  EXPECT_EQ(1, request_count());
+}
+
+IN_PROC_BROWSER_TEST_F(EthJsonRpcBrowserTest, DeduplicateAndCacheRequests) {
+  ResetHTTPSServer(
+      base::BindRepeating(&EthJsonRpcBrowserTest::HandleBatchRequest,
+                          base::Unretained(this)));
+  auto* controller = GetEthJsonRpcController();
+
+  base::RunLoop run_loop;
+  base::RepeatingClosure barrier =
+      base::BarrierClosure(2, run_loop.QuitClosure());
+  controller->GetBalance(
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, barrier, std::string("0xb539d5")));
+  controller->GetBalance(
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, barrier, std::string("0xb539d5")));
+  run_loop.Run();
+
+  EXPECT_EQ(1, request_count());
+
+  // Answered from the cache while the block number is current.
+  base::RunLoop cached_run_loop;
+  controller->GetBalance(
+      "0x4e02f254184E904300e0775E4b8eeCB1",
+      base::BindOnce(&OnBalance, cached_run_loop.QuitClosure(),
+                     std::string("0xb539d5")));
+  cached_run_loop.Run();
+
+  EXPECT_EQ(1, request_count());
+}
@@ -7,11 +7,14 @@
 #define BRAVE_BROWSER_IMPORTER_BRAVE_EXTERNAL_PROCESS_IMPORTER_CLIENT_H_
 
 #include <string>
+#include <vector>
 
 #include "base/memory/weak_ptr.h"
 #include "base/strings/string16.h"
 #include "brave/common/importer/profile_import.mojom.h"
 #include "chrome/browser/importer/external_process_importer_client.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "components/favicon_base/favicon_usage_data.h"
 #include "mojo/public/cpp/bindings/receiver.h"
 #include "mojo/public/cpp/bindings/remote.h"
 
@@ -36,6 +39,13 @@ class BraveExternalProcessImporterClient
   void CloseMojoHandles() override;
   void OnImportItemFinished(importer::ImportItem import_item) override;
 
+  // chrome::mojom::ProfileImportObserver overrides:
+  void OnHistoryImportGroup(
+      const std::vector<ImporterURLRow>& history_rows_group,
+      int visit_source) override;
+  void OnFaviconsImportGroup(
+      const favicon_base::FaviconUsageDataList& favicons_group) override;
+
   // brave::mojom::ProfileImportObserver overrides:
   void OnCreditCardImportReady(
       const base::string16& name_on_card,
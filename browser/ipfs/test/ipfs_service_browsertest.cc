@@ -3,6 +3,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <atomic>
+
+#include "base/barrier_closure.h"
 #include "base/base64.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
@@ -397,6 +400,33 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
     ASSERT_FALSE(success);
   }
 
+  std::unique_ptr<net::test_server::HttpResponse> HandleCountRepoStats(
+      const net::test_server::HttpRequest& request) {
+    if (request.GetURL().path_piece() == kRepoStatsPath) {
+      repo_stats_requests_++;
+      return HandleGetRepoStats(request);
+    }
+    return HandleGarbageCollection(request);
+  }
+
+  // Makes |count| concurrent GetRepoStats calls and waits for all of them.
+  void GetRepoStats(int count) {
+    base::RunLoop run_loop;
+    auto barrier = base::BarrierClosure(count, run_loop.QuitClosure());
+    for (int i = 0; i < count; i++) {
+      ipfs_service()->GetRepoStats(base::BindOnce(
+          [](base::OnceClosure done, bool success, const RepoStats& stats) {
+            EXPECT_TRUE(success);
+            EXPECT_EQ(stats.objects, uint64_t(113));
+            std::move(done).Run();
+          },
+          barrier));
+    }
+    run_loop.Run();
+  }
+
+  int repo_stats_requests() const { return repo_stats_requests_; }
+
   void WaitForRequest() {
     if (wait_for_request_) {
       return;
@@ -409,6 +439,8 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
  private:
   std::unique_ptr<base::RunLoop> wait_for_request_;
   std::unique_ptr<net::EmbeddedTestServer> test_server_;
+  // Written on the test server thread.
+  std::atomic<int> repo_stats_requests_{0};
   IpfsService* ipfs_service_;
   base::test::ScopedFeatureList feature_list_;
 };
@@ -485,6 +517,32 @@ IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, GetRepoStatsServerError) {
   WaitForRequest();
 }
 
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, GetRepoStatsSharesRequests) {
+  ResetTestServer(base::BindRepeating(
+      &IpfsServiceBrowserTest::HandleCountRepoStats, base::Unretained(this)));
+  ipfs_service()->SetAPICacheTTLForTest(base::TimeDelta::FromMinutes(1));
+
+  // Concurrent reads share one request.
+  GetRepoStats(2);
+  EXPECT_EQ(repo_stats_requests(), 1);
+
+  // Reads within the TTL are answered from the cache.
+  GetRepoStats(1);
+  EXPECT_EQ(repo_stats_requests(), 1);
+
+  // Garbage collection changes the repo, so stats are requested again.
+  base::RunLoop run_loop;
+  ipfs_service()->RunGarbageCollection(base::BindOnce(
+      [](base::OnceClosure done, bool success, const std::string& error) {
+        EXPECT_TRUE(success);
+        std::move(done).Run();
+      },
+      run_loop.QuitClosure()));
+  run_loop.Run();
+  GetRepoStats(1);
+  EXPECT_EQ(repo_stats_requests(), 2);
+}
+
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, GetNodeInfoServerSuccess) {
   ResetTestServer(base::BindRepeating(
       &IpfsServiceBrowserTest::HandleGetNodeInfo, base::Unretained(this)));
@@ -5,6 +5,8 @@
 
 #include "base/bind.h"
 #include "base/path_service.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
 #include "brave/app/brave_command_ids.h"
 #include "brave/common/brave_paths.h"
 #include "brave/components/speedreader/features.h"
@@ -18,6 +20,8 @@
 #include "content/public/test/browser_test_utils.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/embedded_test_server/http_request.h"
+#include "net/test/embedded_test_server/http_response.h"
 
 const char kTestHost[] = "theguardian.com";
 const char kTestPage[] = "/guardian.html";
@@ -30,6 +34,34 @@ constexpr char kSpeedreaderToggleUMAHistogramName[] =
 constexpr char kSpeedreaderEnabledUMAHistogramName[] =
     "Brave.SpeedReader.Enabled";
 
+// Serves /article?<size> as a readable page of at least <size> bytes.
+std::unique_ptr<net::test_server::HttpResponse> HandleArticleRequest(
+    const net::test_server::HttpRequest& request) {
+  const GURL url = request.GetURL();
+  size_t size = 0;
+  if (url.path_piece() != "/article" ||
+      !base::StringToSizeT(url.query_piece(), &size)) {
+    return nullptr;
+  }
+
+  std::string body =
+      "<html><head><title>Article</title></head><body><article>"
+      "<h1>Article</h1>";
+  while (body.size() < size) {
+    body +=
+        "<p>Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+        "eiusmod tempor incididunt ut labore et dolore magna aliqua. Ut enim "
+        "ad minim veniam, quis nostrud exercitation ullamco laboris.</p>";
+  }
+  body += "</article></body></html>";
+
+  auto response = std::make_unique<net::test_server::BasicHttpResponse>();
+  response->set_code(net::HTTP_OK);
+  response->set_content_type("text/html");
+  response->set_content(body);
+  return response;
+}
+
 class SpeedReaderBrowserTest : public InProcessBrowserTest {
  public:
   SpeedReaderBrowserTest()
@@ -110,3 +142,41 @@ IN_PROC_BROWSER_TEST_F(SpeedReaderBrowserTest, P3ATest) {
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 1, 1);
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 2, 0);
 }
+
+class SpeedReaderClassifyAllBrowserTest : public SpeedReaderBrowserTest {
+ public:
+  SpeedReaderClassifyAllBrowserTest()
+      : article_server_(net::EmbeddedTestServer::TYPE_HTTPS) {
+    article_server_.SetSSLConfig(net::EmbeddedTestServer::CERT_OK);
+    article_server_.RegisterRequestHandler(
+        base::BindRepeating(&HandleArticleRequest));
+    EXPECT_TRUE(article_server_.Start());
+  }
+
+  void SetUpCommandLine(base::CommandLine* command_line) override {
+    SpeedReaderBrowserTest::SetUpCommandLine(command_line);
+    command_line->AppendSwitchASCII(speedreader::kSpeedreaderBackend,
+                                    "classify-all");
+  }
+
+ protected:
+  net::EmbeddedTestServer article_server_;
+};
+
+// The heuristics backend only produces output once the whole page is written,
+// so pages on both sides of the 2 MiB limit on the kept original body are
+// distilled.
+IN_PROC_BROWSER_TEST_F(SpeedReaderClassifyAllBrowserTest, DistillsLargePages) {
+  chrome::ExecuteCommand(browser(), IDC_TOGGLE_SPEEDREADER);
+  for (const char* size : {"1048576", "3145728"}) {
+    const GURL url =
+        article_server_.GetURL(kTestHost, base::StrCat({"/article?", size}));
+    ui_test_utils::NavigateToURL(browser(), url);
+    content::RenderFrameHost* rfh =
+        browser()->tab_strip_model()->GetActiveWebContents()->GetMainFrame();
+    EXPECT_EQ(true, content::EvalJs(rfh,
+                                    "!!document.getElementById("
+                                    "\"brave_speedreader_style\")"))
+        << size;
+  }
+}
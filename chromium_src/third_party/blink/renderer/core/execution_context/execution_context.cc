@@ -5,7 +5,12 @@
 
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/command_line.h"
+#include "base/containers/span.h"
+#include "base/hash/hash.h"
 #include "base/strings/string_number_conversions.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "crypto/hmac.h"
@@ -27,35 +32,92 @@ namespace {
 
 const uint64_t zero = 0;
 
+// Canvases up to 256x256 RGBA are keyed by HMACing every pixel. Larger
+// canvases are digested tile by tile with a fast hash first, and only the
+// tile digests go through the HMAC.
+constexpr size_t kMaxFullCanvasDigestSize = 256 * 256 * 4;
+constexpr size_t kCanvasDigestTileSize = 64 * 1024;
+
 inline uint64_t lfsr_next(uint64_t v) {
   return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
 }
 
-float Identity(float value, size_t index) {
-  return value;
+// returns pseudo-random float between 0 and 0.1
+inline float PseudoRandomSample(uint64_t v) {
+  const double maxUInt64AsDouble = UINT64_MAX;
+  return (v / maxUInt64AsDouble) / 10;
+}
+
+}  // namespace
+
+namespace brave {
+
+AudioFarblingHelper::AudioFarblingHelper() = default;
+
+// static
+AudioFarblingHelper AudioFarblingHelper::CreateConstantMultiplier(
+    double fudge_factor) {
+  AudioFarblingHelper helper;
+  helper.mode_ = Mode::kConstantMultiplier;
+  helper.fudge_factor_ = fudge_factor;
+  return helper;
 }
 
-float ConstantMultiplier(double fudge_factor, float value, size_t index) {
-  return value * fudge_factor;
+// static
+AudioFarblingHelper AudioFarblingHelper::CreatePseudoRandomSequence(
+    uint64_t seed) {
+  AudioFarblingHelper helper;
+  helper.mode_ = Mode::kPseudoRandomSequence;
+  helper.seed_ = seed;
+  helper.lfsr_state_ = seed;
+  return helper;
 }
 
-float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
-  static uint64_t v;
-  const double maxUInt64AsDouble = UINT64_MAX;
-  if (index == 0) {
-    // start of loop, reset to initial seed which was passed in and is based on
-    // the domain key
-    v = seed;
+float AudioFarblingHelper::FarbleSample(float value, size_t index) {
+  switch (mode_) {
+    case Mode::kIdentity:
+      return value;
+    case Mode::kConstantMultiplier:
+      return value * fudge_factor_;
+    case Mode::kPseudoRandomSequence: {
+      if (index == 0) {
+        // start of loop, reset to initial seed which is based on the domain
+        // key
+        lfsr_state_ = seed_;
+      }
+      lfsr_state_ = lfsr_next(lfsr_state_);
+      return PseudoRandomSample(lfsr_state_);
+    }
   }
-  // get next value in PRNG sequence
-  v = lfsr_next(v);
-  // return pseudo-random float between 0 and 0.1
-  return (v / maxUInt64AsDouble) / 10;
+  NOTREACHED();
+  return value;
 }
 
-}  // namespace
+void AudioFarblingHelper::FarbleBlock(float* data, size_t count) {
+  if (!data || count == 0)
+    return;
 
-namespace brave {
+  switch (mode_) {
+    case Mode::kIdentity:
+      return;
+    case Mode::kConstantMultiplier: {
+      // no loop-carried state, so this loop is left to the auto-vectorizer
+      const double fudge_factor = fudge_factor_;
+      for (size_t i = 0; i < count; ++i)
+        data[i] = data[i] * fudge_factor;
+      return;
+    }
+    case Mode::kPseudoRandomSequence: {
+      uint64_t v = seed_;
+      for (size_t i = 0; i < count; ++i) {
+        v = lfsr_next(v);
+        data[i] = PseudoRandomSample(v);
+      }
+      lfsr_state_ = v;
+      return;
+    }
+  }
+}
 
 const char kBraveSessionToken[] = "brave_session_token";
 const char BraveSessionCache::kSupplementName[] = "BraveSessionCache";
@@ -130,7 +192,7 @@ BraveSessionCache& BraveSessionCache::From(ExecutionContext& context) {
   return *cache;
 }
 
-AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
+AudioFarblingHelper BraveSessionCache::GetAudioFarblingHelper(
     blink::WebContentSettingsClient* settings) {
   if (farbling_enabled_ && settings) {
     switch (settings->GetBraveFarblingLevel()) {
@@ -143,15 +205,15 @@ AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
         double fudge_factor = 0.99 + ((*fudge / maxUInt64AsDouble) / 100);
         VLOG(1) << "audio fudge factor (based on session token) = "
                 << fudge_factor;
-        return base::BindRepeating(&ConstantMultiplier, fudge_factor);
+        return AudioFarblingHelper::CreateConstantMultiplier(fudge_factor);
       }
       case BraveFarblingLevel::MAXIMUM: {
         uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
-        return base::BindRepeating(&PseudoRandomSequence, seed);
+        return AudioFarblingHelper::CreatePseudoRandomSequence(seed);
       }
     }
   }
-  return base::BindRepeating(&Identity);
+  return AudioFarblingHelper();
 }
 
 void BraveSessionCache::PerturbPixels(blink::WebContentSettingsClient* settings,
@@ -193,8 +255,25 @@ void BraveSessionCache::PerturbPixelsInternal(const unsigned char* data,
   CHECK(h.Init(reinterpret_cast<const unsigned char*>(&session_plus_domain_key),
                sizeof session_plus_domain_key));
   uint8_t canvas_key[32];
-  CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
-               canvas_key, sizeof canvas_key));
+  if (size <= kMaxFullCanvasDigestSize) {
+    CHECK(h.Sign(base::StringPiece(reinterpret_cast<const char*>(pixels), size),
+                 canvas_key, sizeof canvas_key));
+  } else {
+    // The key still depends on every pixel, so identical contents produce
+    // identical output within a session and domain.
+    std::vector<uint32_t> digest;
+    digest.reserve(size / kCanvasDigestTileSize + 2);
+    digest.push_back(static_cast<uint32_t>(size));
+    for (size_t offset = 0; offset < size; offset += kCanvasDigestTileSize) {
+      const size_t tile_size = std::min(kCanvasDigestTileSize, size - offset);
+      digest.push_back(
+          base::FastHash(base::make_span(pixels + offset, tile_size)));
+    }
+    CHECK(h.Sign(
+        base::StringPiece(reinterpret_cast<const char*>(digest.data()),
+                          digest.size() * sizeof(uint32_t)),
+        canvas_key, sizeof canvas_key));
+  }
   uint64_t v = *reinterpret_cast<uint64_t*>(canvas_key);
   uint64_t pixel_index;
   // choose which channel (R, G, or B) to perturb
@@ -10,8 +10,6 @@
 
 #include <random>
 
-#include "base/callback.h"
-
 namespace blink {
 class WebContentSettingsClient;
 }  // namespace blink
@@ -26,7 +24,34 @@ using blink::TraceTrait;
 
 namespace brave {
 
-typedef base::RepeatingCallback<float(float, size_t)> AudioFarblingCallback;
+// Applies audio farbling to sample data. Blocks are farbled with tight
+// per-mode loops instead of a callback per sample, and the pseudo-random
+// sequence state lives in the helper rather than in a static.
+class CORE_EXPORT AudioFarblingHelper {
+ public:
+  AudioFarblingHelper();
+
+  static AudioFarblingHelper CreateConstantMultiplier(double fudge_factor);
+  static AudioFarblingHelper CreatePseudoRandomSequence(uint64_t seed);
+
+  bool IsIdentity() const { return mode_ == Mode::kIdentity; }
+
+  // Farbles a single sample at |index| of the block being read. The
+  // pseudo-random sequence restarts at index 0.
+  float FarbleSample(float value, size_t index);
+
+  // Farbles |count| samples in place, with the same output as calling
+  // FarbleSample for indices 0 to |count| - 1.
+  void FarbleBlock(float* data, size_t count);
+
+ private:
+  enum class Mode { kIdentity, kConstantMultiplier, kPseudoRandomSequence };
+
+  Mode mode_ = Mode::kIdentity;
+  double fudge_factor_ = 1.0;
+  uint64_t seed_ = 0;
+  uint64_t lfsr_state_ = 0;
+};
 
 CORE_EXPORT blink::WebContentSettingsClient* GetContentSettingsClientFor(
     ExecutionContext* context);
@@ -42,7 +67,7 @@ class CORE_EXPORT BraveSessionCache final
 
   static BraveSessionCache& From(ExecutionContext&);
 
-  AudioFarblingCallback GetAudioFarblingCallback(
+  AudioFarblingHelper GetAudioFarblingHelper(
       blink::WebContentSettingsClient* settings);
   void PerturbPixels(blink::WebContentSettingsClient* settings,
                      const unsigned char* data,
@@ -5,72 +5,75 @@
 
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
 
-#include <algorithm>
 #include <cmath>
-#include <numeric>
-#include <utility>
+#include <string>
+#include <unordered_map>
 
 #include "base/logging.h"
+#include "base/no_destructor.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
 
 namespace {
 
-bool StandardiseFeatsNoOutliers(
-    std::array<double, standardise_feat_count>* features,
-    const std::array<double, standardise_feat_count>& means,
-    const std::array<double, standardise_feat_count>& scale) {
-  for (unsigned int i = 0; i < standardise_feat_count; i++) {
-    features->at(i) = (features->at(i) - means[i]) / scale[i];
-  }
-  for (unsigned int i = 0; i < standardise_feat_count; i++) {
-    if (features->at(i) > kOutlierThreshold ||
-        features->at(i) < -kOutlierThreshold) {
-      VLOG(2) << "Outlier feature " << feature_sequence.at(i) << " with value "
-              << features->at(i);
-      return true;
-    }
-  }
-  return false;
+// Index of each named feature in |feature_sequence|.
+const std::unordered_map<std::string, size_t>& GetFeatureIndex() {
+  static const base::NoDestructor<std::unordered_map<std::string, size_t>>
+      feature_index([] {
+        std::unordered_map<std::string, size_t> index;
+        index.reserve(feature_count);
+        for (size_t i = 0; i < feature_count; i++)
+          index.emplace(feature_sequence[i], i);
+        return index;
+      }());
+  return *feature_index;
 }
 
 }  // namespace
 
 double LinregPredictVector(const std::array<double, feature_count>& features) {
-  // Standardise numeric features
-  std::array<double, standardise_feat_count> numeric_features;
-  std::copy(features.begin(), features.begin() + standardise_feat_count,
-            numeric_features.begin());
-  bool has_outliers = StandardiseFeatsNoOutliers(
-      &numeric_features, standardise_feat_means, standardise_feat_scale);
+  // Standardise numeric features and accumulate their contribution in the
+  // same pass, in feature order so the result matches the model exactly. The
+  // offending feature is only looked up again for logging.
+  double log_prediction = model_intercept;
+  bool has_outliers = false;
+  for (size_t i = 0; i < standardise_feat_count; i++) {
+    const double standardised =
+        (features[i] - standardise_feat_means[i]) / standardise_feat_scale[i];
+    has_outliers |= std::abs(standardised) > kOutlierThreshold;
+    log_prediction += standardised * model_coefficients[i];
+  }
   if (has_outliers) {
+    if (VLOG_IS_ON(2)) {
+      for (size_t i = 0; i < standardise_feat_count; i++) {
+        const double standardised = (features[i] - standardise_feat_means[i]) /
+                                    standardise_feat_scale[i];
+        if (std::abs(standardised) > kOutlierThreshold) {
+          VLOG(2) << "Outlier feature " << feature_sequence[i]
+                  << " with value " << standardised;
+        }
+      }
+    }
     VLOG(2) << "Feature set has outliers, return 0";
     return 0;
   }
 
-  // Create a new feature vector to include all features
-  std::array<double, feature_count> standardised_features;
-  std::move(numeric_features.begin(), numeric_features.end(),
-            standardised_features.begin());
-  // Just copy the rest of the features as-is
-  std::copy(features.begin() + standardise_feat_count, features.end(),
-            standardised_features.begin() + standardise_feat_count);
+  // The rest of the features are used as-is
+  for (size_t i = standardise_feat_count; i < feature_count; i++)
+    log_prediction += features[i] * model_coefficients[i];
 
-  // Calculate the prediction
-  double log_prediction = std::inner_product(
-      standardised_features.begin(), standardised_features.end(),
-      model_coefficients.begin(), model_intercept);
   // We know the target is log-scaled but care about the absolute value
   return std::pow(10, log_prediction);
 }
 
 double LinregPredictNamed(const base::flat_map<std::string, double>& features) {
+  const auto& feature_index = GetFeatureIndex();
   std::array<double, feature_count> feature_vector{};
-  for (unsigned int i = 0; i < feature_count; i++) {
-    auto it = features.find(feature_sequence.at(i));
-    if (it != features.end())
-      feature_vector[i] = it->second;
+  for (const auto& feature : features) {
+    auto it = feature_index.find(feature.first);
+    if (it != feature_index.end())
+      feature_vector[it->second] = feature.second;
   }
   return LinregPredictVector(feature_vector);
 }
@@ -49,8 +49,14 @@ void BandwidthSavingsPredictor::OnSubresourceBlocked(
     const std::string& resource_url) {
   feature_map_["adblockRequests"] += 1;
 
-  if (tp_registry_) {
-    const auto tp_name = tp_registry_->GetThirdParty(resource_url);
+  // Until the registry has loaded every lookup comes back empty, so hosts
+  // blocked before then are left to be resolved by a later request.
+  if (tp_registry_ && tp_registry_->IsInitialized()) {
+    const GURL url(resource_url);
+    // The third-party feature is a flag, so each host needs resolving once.
+    if (url.has_host() && !blocked_hosts_.insert(url.host()).second)
+      return;
+    const auto tp_name = tp_registry_->GetThirdParty(url);
     if (tp_name.has_value())
       feature_map_["thirdParties." + tp_name.value() + ".blocked"] = 1;
   }
@@ -152,6 +158,7 @@ double BandwidthSavingsPredictor::PredictSavingsBytes() const {
 
 void BandwidthSavingsPredictor::Reset() {
   feature_map_.clear();
+  blocked_hosts_.clear();
   main_frame_url_ = {};
 }
 
@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_SAVINGS_PREDICTOR_H_
 
 #include <string>
+#include <unordered_set>
 
 #include "base/containers/flat_map.h"
 #include "base/gtest_prod_util.h"
@@ -58,6 +59,10 @@ class BandwidthSavingsPredictor {
 
  private:
   FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest, FeaturiseBlocked);
+  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
+                           FeaturiseManyBlocked);
+  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
+                           FeaturiseBlockedBeforeRegistryLoaded);
   FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest, FeaturiseTiming);
   FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
                            FeaturiseResourceLoading);
@@ -65,6 +70,9 @@ class BandwidthSavingsPredictor {
   GURL main_frame_url_;
   const NamedThirdPartyRegistry* tp_registry_;  // not owned
   base::flat_map<std::string, double> feature_map_;
+  // Hosts of blocked resources already resolved against |tp_registry_|.
+  // Pages commonly block hundreds of resources from a handful of hosts.
+  std::unordered_set<std::string> blocked_hosts_;
 };
 
 }  // namespace brave_perf_predictor
@@ -9,6 +9,7 @@
 
 #include "base/containers/flat_map.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/task_environment.h"
 #include "base/time/time.h"
 #include "chrome/browser/predictors/loading_test_util.h"
@@ -46,6 +47,40 @@ TEST_F(BandwidthSavingsPredictorTest, FeaturiseBlocked) {
   EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 2);
 }
 
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseManyBlocked) {
+  for (int i = 0; i < 300; i++) {
+    predictor_->OnSubresourceBlocked("https://google-analytics.com/collect?v=" +
+                                     base::NumberToString(i));
+    predictor_->OnSubresourceBlocked("https://connect.facebook.net/" +
+                                     base::NumberToString(i) + ".js");
+  }
+  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 600);
+  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
+            1);
+  EXPECT_EQ(predictor_->feature_map_["thirdParties.Facebook.blocked"], 1);
+  EXPECT_EQ(predictor_->blocked_hosts_.size(), 2u);
+
+  predictor_->Reset();
+  EXPECT_TRUE(predictor_->blocked_hosts_.empty());
+  predictor_->OnSubresourceBlocked("https://google-analytics.com/ga.js");
+  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
+            1);
+}
+
+TEST_F(BandwidthSavingsPredictorTest, FeaturiseBlockedBeforeRegistryLoaded) {
+  tp_registry_->MarkInitialized(false);
+  predictor_->OnSubresourceBlocked("https://google-analytics.com/ga.js");
+  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
+            0);
+  EXPECT_TRUE(predictor_->blocked_hosts_.empty());
+
+  tp_registry_->MarkInitialized(true);
+  predictor_->OnSubresourceBlocked("https://google-analytics.com/collect");
+  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 2);
+  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
+            1);
+}
+
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseTiming) {
   const auto empty_timing = page_load_metrics::CreatePageLoadTiming();
   predictor_->OnPageLoadTimingUpdated(*empty_timing);
@@ -6,6 +6,7 @@
 #include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 
 #include <tuple>
+#include <utility>
 
 #include "base/bind.h"
 #include "base/containers/flat_set.h"
@@ -27,11 +28,13 @@ namespace brave_perf_predictor {
 
 namespace {
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
-  base::flat_map<std::string, std::string> entity_by_domain;
-  base::flat_map<std::string, std::string> entity_by_root_domain;
+using EntityMap = NamedThirdPartyRegistry::EntityMap;
+
+std::tuple<EntityMap, EntityMap> ParseMappings(
+    const base::StringPiece entities,
+    bool discard_irrelevant) {
+  EntityMap entity_by_domain;
+  EntityMap entity_by_root_domain;
 
   // Parse the JSON
   base::Optional<base::Value> document = base::JSONReader::Read(entities);
@@ -57,7 +60,7 @@ ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
       if (!entity_domain_it.is_string()) {
         continue;
       }
-      const base::StringPiece entity_domain(entity_domain_it.GetString());
+      const std::string& entity_domain = entity_domain_it.GetString();
 
       const auto inserted =
           entity_by_domain.emplace(entity_domain, *entity_name);
@@ -79,14 +82,11 @@ ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
     }
   }
 
-  entity_by_domain.shrink_to_fit();
-  entity_by_root_domain.shrink_to_fit();
-  return std::make_tuple(entity_by_domain, entity_by_root_domain);
+  return std::make_tuple(std::move(entity_by_domain),
+                         std::move(entity_by_root_domain));
 }
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseFromResource(int resource_id) {
+std::tuple<EntityMap, EntityMap> ParseFromResource(int resource_id) {
   // TODO(AndriusA): insert trace event here
   SCOPED_UMA_HISTOGRAM_TIMER(
       "Brave.Savings.NamedThirdPartyRegistry.LoadTimeMS");
@@ -116,9 +116,8 @@ bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
 }
 
 void NamedThirdPartyRegistry::UpdateMappings(
-    std::tuple<base::flat_map<std::string, std::string>,
-               base::flat_map<std::string, std::string>> entity_mappings) {
-  tie(entity_by_domain_, entity_by_root_domain_) = entity_mappings;
+    std::tuple<EntityMap, EntityMap> entity_mappings) {
+  tie(entity_by_domain_, entity_by_root_domain_) = std::move(entity_mappings);
   VLOG(2) << "Loaded " << entity_by_domain_.size() << " mappings by domain and "
           << entity_by_root_domain_.size() << " by root domain; size";
   initialized_ = true;
@@ -131,7 +130,16 @@ base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
     return base::nullopt;
   }
 
-  const GURL url(request_url);
+  return GetThirdParty(GURL(request_url));
+}
+
+base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
+    const GURL& url) const {
+  if (!IsInitialized()) {
+    VLOG(2) << "Named Third Party Registry not initialized";
+    return base::nullopt;
+  }
+
   if (!url.is_valid())
     return base::nullopt;
 
@@ -8,12 +8,15 @@
 
 #include <string>
 #include <tuple>
+#include <unordered_map>
 
-#include "base/containers/flat_map.h"
+#include "base/gtest_prod_util.h"
 #include "base/memory/weak_ptr.h"
 #include "base/values.h"
 #include "components/keyed_service/core/keyed_service.h"
 
+class GURL;
+
 namespace brave_perf_predictor {
 
 // Retrieves publicly known Third Party (organisation) for a given URL, using
@@ -35,17 +38,25 @@ class NamedThirdPartyRegistry : public KeyedService {
   void InitializeDefault();
   base::Optional<std::string> GetThirdParty(
       const base::StringPiece domain) const;
+  // Same as above, for callers that already have the URL parsed.
+  base::Optional<std::string> GetThirdParty(const GURL& url) const;
 
- private:
+  // Lookups return nothing until the mappings have loaded.
   bool IsInitialized() const { return initialized_; }
+
+  // Host to entity name hash table, built off the UI thread.
+  using EntityMap = std::unordered_map<std::string, std::string>;
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(BandwidthSavingsPredictorTest,
+                           FeaturiseBlockedBeforeRegistryLoaded);
+
   void MarkInitialized(bool initialized) { initialized_ = initialized; }
-  void UpdateMappings(
-      std::tuple<base::flat_map<std::string, std::string>,
-                 base::flat_map<std::string, std::string>> entity_mappings);
+  void UpdateMappings(std::tuple<EntityMap, EntityMap> entity_mappings);
 
   bool initialized_ = false;
-  base::flat_map<std::string, std::string> entity_by_domain_;
-  base::flat_map<std::string, std::string> entity_by_root_domain_;
+  EntityMap entity_by_domain_;
+  EntityMap entity_by_root_domain_;
 
   base::WeakPtrFactory<NamedThirdPartyRegistry> weak_factory_{this};
 };
@@ -97,6 +97,7 @@ const int kDiagnosticLogMaxVerboseLevel = 6;
 const int kDiagnosticLogKeepNumLines = 20000;
 const int kDiagnosticLogMaxFileSize = 10 * (1024 * 1024);
 const char pref_prefix[] = "brave.rewards";
+const uint32_t kContributionsPageSize = 100;
 
 std::string URLMethodToRequestType(ledger::type::UrlMethod method) {
   switch (method) {
@@ -2960,19 +2961,24 @@ void RewardsServiceImpl::OnRecordBackendP3AStatsRecurring(
     return;
   }
 
-  bat_ledger_->GetAllContributions(
+  bat_ledger_->GetContributionsPage(
+      "",
+      kContributionsPageSize,
       base::BindOnce(&RewardsServiceImpl::OnRecordBackendP3AStatsContributions,
           AsWeakPtr(),
-          list.size()));
+          list.size(),
+          0,
+          0,
+          0));
 }
 
 void RewardsServiceImpl::OnRecordBackendP3AStatsContributions(
     const uint32_t recurring_donation_size,
-    ledger::type::ContributionInfoList list) {
-  int auto_contributions = 0;
-  int tips = 0;
-  int queued_recurring = 0;
-
+    int auto_contributions,
+    int tips,
+    int queued_recurring,
+    ledger::type::ContributionInfoList list,
+    const std::string& next_page_token) {
   for (auto& contribution : list) {
     switch (contribution->type) {
     case ledger::type::RewardsType::AUTO_CONTRIBUTE: {
@@ -2992,6 +2998,24 @@ void RewardsServiceImpl::OnRecordBackendP3AStatsContributions(
     }
   }
 
+  if (!next_page_token.empty()) {
+    if (!Connected()) {
+      return;
+    }
+
+    bat_ledger_->GetContributionsPage(
+        next_page_token,
+        kContributionsPageSize,
+        base::BindOnce(
+            &RewardsServiceImpl::OnRecordBackendP3AStatsContributions,
+            AsWeakPtr(),
+            recurring_donation_size,
+            auto_contributions,
+            tips,
+            queued_recurring));
+    return;
+  }
+
   if (queued_recurring == 0) {
     queued_recurring = recurring_donation_size;
   }
@@ -697,7 +697,11 @@ class RewardsServiceImpl : public RewardsService,
 
   void OnRecordBackendP3AStatsContributions(
       const uint32_t recurring_donation_size,
-      ledger::type::ContributionInfoList list);
+      int auto_contributions,
+      int tips,
+      int queued_recurring,
+      ledger::type::ContributionInfoList list,
+      const std::string& next_page_token);
 
   void OnRecordBackendP3AStatsAC(
       const int auto_contributions,
@@ -5,12 +5,14 @@
 
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/pref_names.h"
 #include "brave/common/render_messages.h"
@@ -53,6 +55,28 @@ using content::WebContents;
 
 namespace {
 
+// Blocked events from the network stack arrive on the UI thread one task per
+// blocked request. They are coalesced per tab and flushed at most this often,
+// which is a few animation frames and well below what the shields panel needs.
+constexpr base::TimeDelta kBlockedEventsFlushDelay =
+    base::TimeDelta::FromMilliseconds(100);
+
+base::TimeDelta g_blocked_events_flush_delay = kBlockedEventsFlushDelay;
+
+// Returns the stats counter pref incremented for a newly blocked subresource
+// of |block_type|, or nullptr.
+const char* GetBlockedCounterPref(const std::string& block_type) {
+  if (block_type == brave_shields::kAds)
+    return kAdsBlocked;
+  if (block_type == brave_shields::kHTTPUpgradableResources)
+    return kHttpsUpgrades;
+  if (block_type == brave_shields::kJavaScript)
+    return kJavascriptBlocked;
+  if (block_type == brave_shields::kFingerprintingV2)
+    return kFingerprintingBlocked;
+  return nullptr;
+}
+
 // Content Settings are only sent to the main frame currently.
 // Chrome may fix this at some point, but for now we do this as a work-around.
 // You can verify if this is fixed by running the following test:
@@ -131,6 +155,7 @@ bool BraveShieldsWebContentsObserver::RenderFrameIdKey::operator==(
 }
 
 BraveShieldsWebContentsObserver::~BraveShieldsWebContentsObserver() {
+  DCHECK(pending_blocked_events_.empty());
 }
 
 BraveShieldsWebContentsObserver::BraveShieldsWebContentsObserver(
@@ -212,12 +237,19 @@ GURL BraveShieldsWebContentsObserver::GetTabURLFromRenderFrameInfo(
 
 bool BraveShieldsWebContentsObserver::IsBlockedSubresource(
     const std::string& subresource) {
-  return blocked_url_paths_.find(subresource) != blocked_url_paths_.end();
+  return blocked_url_paths_.find(std::hash<std::string>()(subresource)) !=
+         blocked_url_paths_.end();
 }
 
 void BraveShieldsWebContentsObserver::AddBlockedSubresource(
     const std::string& subresource) {
-  blocked_url_paths_.insert(subresource);
+  blocked_url_paths_.insert(std::hash<std::string>()(subresource));
+}
+
+// static
+void BraveShieldsWebContentsObserver::SetBlockedEventsFlushDelayForTesting(
+    base::TimeDelta delay) {
+  g_blocked_events_flush_delay = delay;
 }
 
 // static
@@ -231,32 +263,66 @@ void BraveShieldsWebContentsObserver::DispatchBlockedEvent(
 
   WebContents* web_contents = GetWebContents(render_process_id,
     render_frame_id, frame_tree_node_id);
-  DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
+  if (!web_contents)
+    return;
 
-  if (web_contents) {
-    BraveShieldsWebContentsObserver* observer =
-        BraveShieldsWebContentsObserver::FromWebContents(web_contents);
-    if (observer &&
-        !observer->IsBlockedSubresource(subresource)) {
-      observer->AddBlockedSubresource(subresource);
-      PrefService* prefs = Profile::FromBrowserContext(
-          web_contents->GetBrowserContext())->
-          GetOriginalProfile()->
-          GetPrefs();
-
-      if (block_type == kAds) {
-        prefs->SetUint64(kAdsBlocked, prefs->GetUint64(kAdsBlocked) + 1);
-      } else if (block_type == kHTTPUpgradableResources) {
-        prefs->SetUint64(kHttpsUpgrades, prefs->GetUint64(kHttpsUpgrades) + 1);
-      } else if (block_type == kJavaScript) {
-        prefs->SetUint64(kJavascriptBlocked,
-            prefs->GetUint64(kJavascriptBlocked) + 1);
-      } else if (block_type == kFingerprintingV2) {
-        prefs->SetUint64(kFingerprintingBlocked,
-            prefs->GetUint64(kFingerprintingBlocked) + 1);
-      }
-    }
+  BraveShieldsWebContentsObserver* observer =
+      BraveShieldsWebContentsObserver::FromWebContents(web_contents);
+  if (!observer) {
+    DispatchBlockedEventForWebContents(block_type, subresource, web_contents);
+    return;
   }
+  observer->OnBlockedEvent(std::move(block_type), std::move(subresource));
+}
+
+void BraveShieldsWebContentsObserver::OnBlockedEvent(std::string block_type,
+                                                     std::string subresource) {
+  if (!IsBlockedSubresource(subresource)) {
+    AddBlockedSubresource(subresource);
+    if (const char* counter_pref = GetBlockedCounterPref(block_type))
+      pending_blocked_counts_[counter_pref]++;
+  }
+  pending_blocked_events_.push_back(
+      {std::move(block_type), std::move(subresource)});
+
+  if (g_blocked_events_flush_delay.is_zero()) {
+    FlushBlockedEvents();
+    return;
+  }
+  if (!flush_blocked_events_timer_.IsRunning()) {
+    flush_blocked_events_timer_.Start(
+        FROM_HERE, g_blocked_events_flush_delay, this,
+        &BraveShieldsWebContentsObserver::FlushBlockedEvents);
+  }
+}
+
+void BraveShieldsWebContentsObserver::FlushBlockedEvents() {
+  flush_blocked_events_timer_.Stop();
+  if (pending_blocked_events_.empty())
+    return;
+
+  UMA_HISTOGRAM_COUNTS_1000("Brave.Shields.BlockedEventsPerFlush",
+                            pending_blocked_events_.size());
+
+  // The extension API has one event per blocked request, so they are still
+  // broadcast one by one, but from a single task.
+  std::vector<PendingBlockedEvent> events;
+  events.swap(pending_blocked_events_);
+  for (const auto& event : events) {
+    DispatchBlockedEventForWebContents(event.block_type, event.subresource,
+                                       web_contents());
+  }
+
+  if (pending_blocked_counts_.empty())
+    return;
+  PrefService* prefs = Profile::FromBrowserContext(
+      web_contents()->GetBrowserContext())->
+      GetOriginalProfile()->
+      GetPrefs();
+  for (const auto& count : pending_blocked_counts_) {
+    prefs->SetUint64(count.first, prefs->GetUint64(count.first) + count.second);
+  }
+  pending_blocked_counts_.clear();
 }
 
 #if !defined(OS_ANDROID)
@@ -343,6 +409,8 @@ void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
   content::ReloadType reload_type = navigation_handle->GetReloadType();
   if (navigation_handle->IsInMainFrame() &&
       !navigation_handle->IsSameDocument()) {
+    // Events of the previous page must not be attributed to the new one.
+    FlushBlockedEvents();
     if (reload_type == content::ReloadType::NONE) {
       // For new loads, we reset the counters for both blocked scripts and URLs.
       allowed_script_origins_.clear();
@@ -360,6 +428,10 @@ void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
         MSG_ROUTING_NONE, allowed_script_origins_));
 }
 
+void BraveShieldsWebContentsObserver::WebContentsDestroyed() {
+  FlushBlockedEvents();
+}
+
 void BraveShieldsWebContentsObserver::AllowScriptsOnce(
     const std::vector<std::string>& origins, WebContents* contents) {
   allowed_script_origins_ = std::move(origins);
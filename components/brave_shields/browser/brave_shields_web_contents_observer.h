@@ -7,13 +7,15 @@
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_BRAVE_SHIELDS_WEB_CONTENTS_OBSERVER_H_
 
 #include <map>
-#include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "base/macros.h"
 #include "base/synchronization/lock.h"
 #include "base/strings/string16.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
 
@@ -21,6 +23,7 @@ namespace content {
 class WebContents;
 }
 
+class BraveShieldsWebContentsObserverTest;
 class PrefRegistrySimple;
 
 namespace brave_shields {
@@ -49,6 +52,10 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
   bool IsBlockedSubresource(const std::string& subresource);
   void AddBlockedSubresource(const std::string& subresource);
 
+  // Blocked events and stats counters are coalesced per tab and flushed after
+  // |delay|. A zero delay flushes every event right away.
+  static void SetBlockedEventsFlushDelayForTesting(base::TimeDelta delay);
+
  protected:
     // A set of identifiers that uniquely identifies a RenderFrame.
   struct RenderFrameIdKey {
@@ -74,6 +81,7 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
       content::NavigationHandle* navigation_handle) override;
   void DidFinishNavigation(
       content::NavigationHandle* navigation_handle) override;
+  void WebContentsDestroyed() override;
 
   // Invoked if an IPC message is coming from a specific RenderFrameHost.
   bool OnMessageReceived(const IPC::Message& message,
@@ -93,11 +101,27 @@ class BraveShieldsWebContentsObserver : public content::WebContentsObserver,
   static std::map<int, GURL> frame_tree_node_id_to_tab_url_;
 
  private:
+  friend class ::BraveShieldsWebContentsObserverTest;
   friend class content::WebContentsUserData<BraveShieldsWebContentsObserver>;
+
+  struct PendingBlockedEvent {
+    std::string block_type;
+    std::string subresource;
+  };
+
+  void OnBlockedEvent(std::string block_type, std::string subresource);
+  void FlushBlockedEvents();
+
   std::vector<std::string> allowed_script_origins_;
   // We keep a set of the current page's blocked URLs in case the page
-  // continually tries to load the same blocked URLs.
-  std::set<std::string> blocked_url_paths_;
+  // continually tries to load the same blocked URLs. Only hashes of the URLs
+  // are kept; a collision merely leaves a blocked resource uncounted.
+  std::unordered_set<size_t> blocked_url_paths_;
+
+  // Blocked events and stats counter increments not dispatched yet.
+  std::vector<PendingBlockedEvent> pending_blocked_events_;
+  std::map<std::string /* pref name */, uint64_t> pending_blocked_counts_;
+  base::OneShotTimer flush_blocked_events_timer_;
 
   WEB_CONTENTS_USER_DATA_KEY_DECL();
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsWebContentsObserver);
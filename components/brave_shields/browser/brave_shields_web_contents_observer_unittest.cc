@@ -0,0 +1,86 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "brave/common/pref_names.h"
+#include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "chrome/test/base/chrome_render_view_host_test_harness.h"
+#include "chrome/test/base/testing_profile.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::BraveShieldsWebContentsObserver;
+
+class BraveShieldsWebContentsObserverTest
+    : public ChromeRenderViewHostTestHarness {
+ public:
+  BraveShieldsWebContentsObserverTest()
+      : ChromeRenderViewHostTestHarness(
+            base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+
+  void SetUp() override {
+    ChromeRenderViewHostTestHarness::SetUp();
+    BraveShieldsWebContentsObserver::CreateForWebContents(web_contents());
+    pref_change_registrar_.Init(profile()->GetPrefs());
+    pref_change_registrar_.Add(
+        kAdsBlocked,
+        base::BindRepeating(&BraveShieldsWebContentsObserverTest::OnPrefChanged,
+                            base::Unretained(this)));
+  }
+
+  void TearDown() override {
+    pref_change_registrar_.RemoveAll();
+    ChromeRenderViewHostTestHarness::TearDown();
+  }
+
+ protected:
+  void OnBlockedEvent(const std::string& block_type,
+                      const std::string& subresource) {
+    BraveShieldsWebContentsObserver::FromWebContents(web_contents())
+        ->OnBlockedEvent(block_type, subresource);
+  }
+
+  uint64_t GetAdsBlocked() {
+    return profile()->GetPrefs()->GetUint64(kAdsBlocked);
+  }
+
+  int pref_writes_ = 0;
+
+ private:
+  void OnPrefChanged() { pref_writes_++; }
+
+  PrefChangeRegistrar pref_change_registrar_;
+};
+
+TEST_F(BraveShieldsWebContentsObserverTest, CoalescesBlockedEvents) {
+  const int kEvents = 5;
+  for (int i = 0; i < kEvents; i++) {
+    OnBlockedEvent(brave_shields::kAds,
+                   "https://ads.example.com/" + base::NumberToString(i));
+  }
+  // The same resource blocked again is not counted twice.
+  OnBlockedEvent(brave_shields::kAds, "https://ads.example.com/0");
+
+  task_environment()->FastForwardBy(base::TimeDelta::FromMilliseconds(50));
+  EXPECT_EQ(pref_writes_, 0);
+  EXPECT_EQ(GetAdsBlocked(), 0ULL);
+
+  task_environment()->FastForwardBy(base::TimeDelta::FromMilliseconds(50));
+  EXPECT_EQ(pref_writes_, 1);
+  EXPECT_EQ(GetAdsBlocked(), static_cast<uint64_t>(kEvents));
+
+  // Events after a flush start a new batch.
+  OnBlockedEvent(brave_shields::kAds, "https://ads.example.com/next");
+  task_environment()->FastForwardBy(base::TimeDelta::FromMilliseconds(100));
+  EXPECT_EQ(pref_writes_, 2);
+  EXPECT_EQ(GetAdsBlocked(), static_cast<uint64_t>(kEvents + 1));
+}
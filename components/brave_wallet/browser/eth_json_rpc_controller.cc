@@ -7,7 +7,13 @@
 
 #include <utility>
 
+#include "base/bind.h"
 #include "base/environment.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/components/brave_wallet/browser/eth_call_data_builder.h"
 #include "brave/components/brave_wallet/browser/eth_requests.h"
 #include "brave/components/brave_wallet/browser/eth_response_parser.h"
@@ -44,6 +50,39 @@ net::NetworkTrafficAnnotationTag GetNetworkTrafficAnnotationTag() {
 
 const unsigned int kRetriesCountOnNetworkChange = 1;
 
+// Calls made within this delay of each other are sent in one batch.
+constexpr base::TimeDelta kBatchDelay = base::TimeDelta::FromMilliseconds(20);
+constexpr size_t kMaxBatchSize = 50;
+
+// Blocks are mined every ~13 seconds, so a block number is trusted for a
+// fraction of that before cached responses need a fresh one.
+constexpr base::TimeDelta kBlockNumberMaxAge = base::TimeDelta::FromSeconds(4);
+
+std::string GetJSON(const base::Value& value) {
+  std::string json;
+  base::JSONWriter::Write(value, &json);
+  return json;
+}
+
+base::Value GetBlockNumberRequest(int id) {
+  base::Value request(base::Value::Type::DICTIONARY);
+  request.SetStringKey("jsonrpc", "2.0");
+  request.SetStringKey("method", "eth_blockNumber");
+  request.SetKey("params", base::Value(base::Value::Type::LIST));
+  request.SetIntKey("id", id);
+  return request;
+}
+
+bool IsSuccessStatus(const int status) {
+  return status >= 200 && status <= 299;
+}
+
+// A batch rejected for one of these reasons says nothing about whether the
+// provider supports batches.
+bool IsTransientFailureStatus(const int status) {
+  return status < 200 || status == 429 || status >= 500;
+}
+
 std::string GetInfuraProjectID() {
   std::string project_id(BRAVE_INFURA_PROJECT_ID);
   std::unique_ptr<base::Environment> env(base::Environment::Create());
@@ -73,6 +112,15 @@ EthJsonRpcController::EthJsonRpcController(content::BrowserContext* context,
 
 EthJsonRpcController::~EthJsonRpcController() {}
 
+EthJsonRpcController::PendingCall::PendingCall() = default;
+
+EthJsonRpcController::PendingCall::PendingCall(PendingCall&& other) = default;
+
+EthJsonRpcController::PendingCall& EthJsonRpcController::PendingCall::operator=(
+    PendingCall&& other) = default;
+
+EthJsonRpcController::PendingCall::~PendingCall() = default;
+
 void EthJsonRpcController::Request(const std::string& json_payload,
                                    URLRequestCallback callback,
                                    bool auto_retry_on_network_change) {
@@ -132,6 +180,234 @@ void EthJsonRpcController::OnURLLoaderComplete(
                           headers);
 }
 
+void EthJsonRpcController::BatchRequest(const std::string& json_payload,
+                                        URLRequestCallback callback,
+                                        bool cacheable) {
+  base::Optional<base::Value> request = base::JSONReader::Read(json_payload);
+  if (!request || !request->is_dict()) {
+    Request(json_payload, std::move(callback), true);
+    return;
+  }
+
+  request->RemoveKey("id");
+  // Calls are only shared within a network, so a call made after switching
+  // networks never joins one still pending on the previous network.
+  const std::string call_key = network_url_.spec() + GetJSON(*request);
+
+  if (cacheable && HasCurrentBlockNumber()) {
+    auto iter = response_cache_.find(call_key);
+    if (iter != response_cache_.end() &&
+        iter->second.block_number == block_number_) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(std::move(callback), 200,
+                                    iter->second.response,
+                                    std::map<std::string, std::string>()));
+      return;
+    }
+  }
+
+  auto iter = pending_calls_.find(call_key);
+  if (iter != pending_calls_.end()) {
+    iter->second.callbacks.push_back(std::move(callback));
+    return;
+  }
+
+  PendingCall call;
+  call.request = std::move(*request);
+  call.cacheable = cacheable;
+  call.callbacks.push_back(std::move(callback));
+  pending_calls_.emplace(call_key, std::move(call));
+  queued_call_keys_.push_back(call_key);
+
+  if (queued_call_keys_.size() >= kMaxBatchSize) {
+    SendBatch();
+  } else if (!batch_timer_.IsRunning()) {
+    batch_timer_.Start(FROM_HERE, kBatchDelay,
+                       base::BindOnce(&EthJsonRpcController::SendBatch,
+                                      base::Unretained(this)));
+  }
+}
+
+void EthJsonRpcController::SendBatch() {
+  batch_timer_.Stop();
+
+  std::vector<std::string> call_keys;
+  call_keys.swap(queued_call_keys_);
+  if (call_keys.empty())
+    return;
+
+  if (!batches_supported_) {
+    for (const auto& call_key : call_keys)
+      SendCall(call_key, false);
+    return;
+  }
+
+  base::Value batch(base::Value::Type::LIST);
+  bool has_cacheable_call = false;
+  for (size_t i = 0; i < call_keys.size(); ++i) {
+    const PendingCall& call = pending_calls_.at(call_keys[i]);
+    base::Value request = call.request.Clone();
+    request.SetIntKey("id", static_cast<int>(i));
+    batch.Append(std::move(request));
+    has_cacheable_call |= call.cacheable;
+  }
+
+  // Responses are cached for the block the provider is at when it answers
+  // the batch.
+  if (has_cacheable_call)
+    batch.Append(GetBlockNumberRequest(static_cast<int>(call_keys.size())));
+
+  Request(GetJSON(batch),
+          base::BindOnce(&EthJsonRpcController::OnBatchResponse,
+                         base::Unretained(this), network_url_,
+                         std::move(call_keys)),
+          true);
+}
+
+void EthJsonRpcController::OnBatchResponse(
+    const GURL& network_url,
+    const std::vector<std::string>& call_keys,
+    const int status,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers) {
+  base::Optional<base::Value> responses;
+  if (IsSuccessStatus(status))
+    responses = base::JSONReader::Read(body);
+  if (!responses || !responses->is_list()) {
+    // Providers reject batches in many ways, so the calls are retried one by
+    // one. Batching is turned off if those succeed where the batch did not.
+    const bool batch_may_be_unsupported = !IsTransientFailureStatus(status);
+    for (const auto& call_key : call_keys)
+      SendCall(call_key, batch_may_be_unsupported);
+    return;
+  }
+
+  const bool is_current_network = network_url == network_url_;
+
+  std::vector<const base::Value*> responses_by_id(call_keys.size() + 1,
+                                                  nullptr);
+  for (const auto& response : responses->GetList()) {
+    if (!response.is_dict())
+      continue;
+    base::Optional<int> id = response.FindIntKey("id");
+    if (!id || *id < 0 || static_cast<size_t>(*id) >= responses_by_id.size())
+      continue;
+    responses_by_id[*id] = &response;
+  }
+
+  const base::Value* block_number_response = responses_by_id.back();
+  if (block_number_response && is_current_network) {
+    const std::string* result =
+        block_number_response->FindStringKey("result");
+    uint64_t block_number = 0;
+    if (result && base::HexStringToUInt64(*result, &block_number)) {
+      if (block_number != block_number_)
+        response_cache_.clear();
+      block_number_ = block_number;
+      block_number_time_ = base::TimeTicks::Now();
+    }
+  }
+
+  for (size_t i = 0; i < call_keys.size(); ++i) {
+    const base::Value* response = responses_by_id[i];
+    if (!response) {
+      RunPendingCall(call_keys[i], status, "", headers);
+      continue;
+    }
+
+    auto iter = pending_calls_.find(call_keys[i]);
+    if (iter == pending_calls_.end())
+      continue;
+
+    const std::string response_json = GetJSON(*response);
+    if (is_current_network && block_number_response &&
+        iter->second.cacheable && response->FindKey("result")) {
+      CachedResponse& cached_response = response_cache_[call_keys[i]];
+      cached_response.block_number = block_number_;
+      cached_response.response = response_json;
+    }
+
+    RunPendingCall(call_keys[i], status, response_json, headers);
+  }
+}
+
+void EthJsonRpcController::SendCall(const std::string& call_key,
+                                    bool after_rejected_batch) {
+  // The call is dropped if the network changed while its batch was pending.
+  auto iter = pending_calls_.find(call_key);
+  if (iter == pending_calls_.end())
+    return;
+
+  base::Value request = iter->second.request.Clone();
+  request.SetIntKey("id", 1);
+  Request(GetJSON(request),
+          base::BindOnce(&EthJsonRpcController::OnCallResponse,
+                         base::Unretained(this), network_url_, call_key,
+                         after_rejected_batch),
+          true);
+}
+
+void EthJsonRpcController::OnCallResponse(
+    const GURL& network_url,
+    const std::string& call_key,
+    bool after_rejected_batch,
+    const int status,
+    const std::string& body,
+    const std::map<std::string, std::string>& headers) {
+  if (after_rejected_batch && IsSuccessStatus(status) &&
+      network_url == network_url_) {
+    // Only a result shows the call got through where the batch did not; an
+    // error such as a rate limit may have rejected the batch just the same.
+    base::Optional<base::Value> response = base::JSONReader::Read(body);
+    if (response && response->is_dict() && response->FindKey("result"))
+      batches_supported_ = false;
+  }
+  RunPendingCall(call_key, status, body, headers);
+}
+
+void EthJsonRpcController::RunPendingCall(
+    const std::string& call_key,
+    const int status,
+    const std::string& response,
+    const std::map<std::string, std::string>& headers) {
+  auto iter = pending_calls_.find(call_key);
+  if (iter == pending_calls_.end())
+    return;
+
+  // Callbacks may make the same call again, which must not join this one.
+  PendingCall call = std::move(iter->second);
+  pending_calls_.erase(iter);
+
+  for (auto& callback : call.callbacks)
+    std::move(callback).Run(status, response, headers);
+}
+
+bool EthJsonRpcController::HasCurrentBlockNumber() const {
+  return !block_number_time_.is_null() &&
+         base::TimeTicks::Now() - block_number_time_ < kBlockNumberMaxAge;
+}
+
+void EthJsonRpcController::ResetBatchState() {
+  batches_supported_ = true;
+  block_number_ = 0;
+  block_number_time_ = base::TimeTicks();
+  response_cache_.clear();
+
+  // Calls made for the previous network fail instead of being sent to, or
+  // answered by, the new one. They fail asynchronously so that callers are
+  // not re-entered while the network is being switched.
+  batch_timer_.Stop();
+  queued_call_keys_.clear();
+  for (auto& pending_call : pending_calls_) {
+    for (auto& callback : pending_call.second.callbacks) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(std::move(callback), -1, std::string(),
+                                    std::map<std::string, std::string>()));
+    }
+  }
+  pending_calls_.clear();
+}
+
 Network EthJsonRpcController::GetNetwork() const {
   return network_;
 }
@@ -161,8 +437,10 @@ void EthJsonRpcController::SetNetwork(Network network) {
       break;
     case Network::kLocalhost:
       network_url_ = GURL("http://localhost:8545");
+      ResetBatchState();
       return;
     case Network::kCustom:
+      ResetBatchState();
       return;
   }
 
@@ -172,11 +450,13 @@ void EthJsonRpcController::SetNetwork(Network network) {
                              : "https://%s-infura.brave.com/%s",
                          subdomain.c_str(), GetInfuraProjectID().c_str());
   network_url_ = GURL(spec);
+  ResetBatchState();
 }
 
 void EthJsonRpcController::SetCustomNetwork(const GURL& network_url) {
   network_ = Network::kCustom;
   network_url_ = network_url;
+  ResetBatchState();
 }
 
 void EthJsonRpcController::GetBalance(
@@ -185,8 +465,8 @@ void EthJsonRpcController::GetBalance(
   auto internal_callback =
       base::BindOnce(&EthJsonRpcController::OnGetBalance,
                      base::Unretained(this), std::move(callback));
-  return Request(eth_getBalance(address, "latest"),
-                 std::move(internal_callback), true);
+  BatchRequest(eth_getBalance(address, "latest"), std::move(internal_callback),
+               true);
 }
 
 void EthJsonRpcController::OnGetBalance(
@@ -218,8 +498,8 @@ bool EthJsonRpcController::GetERC20TokenBalance(
   if (!erc20::BalanceOf(address, &data)) {
     return false;
   }
-  Request(eth_call("", address, "", "", "", data, ""),
-          std::move(internal_callback), true);
+  BatchRequest(eth_call("", address, "", "", "", data, ""),
+               std::move(internal_callback), true);
   return true;
 }
 
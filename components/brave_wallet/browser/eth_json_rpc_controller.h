@@ -10,8 +10,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "url/gurl.h"
 
@@ -37,6 +41,14 @@ class EthJsonRpcController {
   void Request(const std::string& json_payload,
                URLRequestCallback callback,
                bool auto_retry_on_network_change);
+  // Like Request(), but coalesces calls made within a short window into one
+  // JSON-RPC batch, shares identical calls which are already pending and,
+  // if |cacheable|, answers from responses fetched at the current block.
+  // Only for read-only calls, and the response passed to |callback| does not
+  // keep the id of |json_payload|.
+  void BatchRequest(const std::string& json_payload,
+                    URLRequestCallback callback,
+                    bool cacheable);
   using GetBallanceCallback =
       base::OnceCallback<void(bool status, const std::string& balance)>;
   void GetBalance(const std::string& address, GetBallanceCallback callback);
@@ -62,6 +74,46 @@ class EthJsonRpcController {
   void OnURLLoaderComplete(SimpleURLLoaderList::iterator iter,
                            URLRequestCallback callback,
                            const std::unique_ptr<std::string> response_body);
+
+  // A call waiting to be sent or answered, shared by all identical calls.
+  struct PendingCall {
+    PendingCall();
+    PendingCall(PendingCall&& other);
+    PendingCall& operator=(PendingCall&& other);
+    ~PendingCall();
+
+    // The JSON-RPC request without its id.
+    base::Value request;
+    bool cacheable = false;
+    std::vector<URLRequestCallback> callbacks;
+  };
+
+  struct CachedResponse {
+    uint64_t block_number = 0;
+    std::string response;
+  };
+
+  void SendBatch();
+  void OnBatchResponse(const GURL& network_url,
+                       const std::vector<std::string>& call_keys,
+                       const int status,
+                       const std::string& body,
+                       const std::map<std::string, std::string>& headers);
+  // Sends a call on its own. |after_rejected_batch| is set when the call's
+  // batch got no usable reply for a reason other than a transient failure.
+  void SendCall(const std::string& call_key, bool after_rejected_batch);
+  void OnCallResponse(const GURL& network_url,
+                      const std::string& call_key,
+                      bool after_rejected_batch,
+                      const int status,
+                      const std::string& body,
+                      const std::map<std::string, std::string>& headers);
+  void RunPendingCall(const std::string& call_key,
+                      const int status,
+                      const std::string& response,
+                      const std::map<std::string, std::string>& headers);
+  bool HasCurrentBlockNumber() const;
+  void ResetBatchState();
   void OnGetBalance(GetBallanceCallback callback,
                     const int status,
                     const std::string& body,
@@ -76,6 +128,21 @@ class EthJsonRpcController {
   GURL network_url_;
   SimpleURLLoaderList url_loaders_;
   Network network_;
+
+  // Pending calls by their network and request without id, and the keys of
+  // those which wait for the next batch. Dropped when the network changes.
+  std::map<std::string, PendingCall> pending_calls_;
+  std::vector<std::string> queued_call_keys_;
+  base::OneShotTimer batch_timer_;
+  // Cleared when calls of a rejected batch succeed on their own, after which
+  // calls are sent one by one.
+  bool batches_supported_ = true;
+
+  // The latest block number reported by the provider, which scopes
+  // |response_cache_|.
+  uint64_t block_number_ = 0;
+  base::TimeTicks block_number_time_;
+  std::map<std::string, CachedResponse> response_cache_;
 };
 
 }  // namespace brave_wallet
@@ -5,10 +5,18 @@
 
 #include "brave/components/brave_wallet/browser/hd_key.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
 #include "base/check.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/system/sys_info.h"
+#include "base/task/thread_pool.h"
 #include "brave/third_party/bitcoin-core/src/src/base58.h"
 #include "brave/third_party/bitcoin-core/src/src/crypto/ripemd160.h"
 #include "crypto/sha2.h"
@@ -22,6 +30,76 @@ constexpr char kMasterSecret[] = "Bitcoin seed";
 #define HARDENED_OFFSET 0x80000000
 #define MAINNET_PUBLIC 0x0488B21E
 #define MAINNET_PRIVATE 0x0488ADE4
+
+// Enough for a few accounts' worth of m/44'/60'/0'/0 style prefixes
+constexpr size_t kDerivedCacheSize = 32;
+// Smaller batches are not worth the cost of posting a task
+constexpr size_t kMinChildrenPerTask = 16;
+
+using DerivedChildren =
+    base::RefCountedData<std::vector<std::unique_ptr<HDKey>>>;
+
+const secp256k1_context* GetSecp256k1Context() {
+  // Creating a context precomputes its tables, which is much more expensive
+  // than deriving a key, so all keys share one
+  static const secp256k1_context* context = secp256k1_context_create(
+      SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+  return context;
+}
+
+bool IsValidChildRange(uint32_t start_index, size_t count) {
+  return static_cast<uint64_t>(start_index) + count <= (uint64_t{1} << 32);
+}
+
+// Parses m/[n|n']*/[n|n']*... into child indexes
+bool ParseDerivationPath(const std::string& path,
+                         std::vector<uint32_t>* indexes) {
+  std::vector<std::string> entries =
+      base::SplitString(path, "/", base::WhitespaceHandling::TRIM_WHITESPACE,
+                        base::SplitResult::SPLIT_WANT_NONEMPTY);
+  if (entries.empty())
+    return false;
+  if (entries[0] != "m") {
+    LOG(ERROR) << __func__ << ": path must starts with \"m\"";
+    return false;
+  }
+  for (size_t i = 1; i < entries.size(); ++i) {
+    std::string entry = entries[i];
+    bool is_hardened = entry.length() > 1 && entry.back() == '\'';
+    if (is_hardened)
+      entry.pop_back();
+    unsigned child_index = 0;
+    if (!base::StringToUint(entry, &child_index)) {
+      LOG(ERROR) << __func__ << ": path must contains number or number'";
+      return false;
+    }
+    if (child_index >= HARDENED_OFFSET) {
+      LOG(ERROR) << __func__ << ": index must be less than " << HARDENED_OFFSET;
+      return false;
+    }
+    if (is_hardened)
+      child_index += HARDENED_OFFSET;
+    indexes->push_back(child_index);
+  }
+  return true;
+}
+
+void DeriveChildrenOnThreadPool(std::unique_ptr<HDKey> parent,
+                                uint32_t start_index,
+                                size_t offset,
+                                size_t count,
+                                scoped_refptr<DerivedChildren> children) {
+  std::vector<std::unique_ptr<HDKey>> derived =
+      parent->DeriveChildren(start_index + offset, count);
+  // Each task owns a disjoint range of the preallocated |children|
+  std::move(derived.begin(), derived.end(), children->data.begin() + offset);
+}
+
+void OnChildrenDerived(scoped_refptr<DerivedChildren> children,
+                       HDKey::DeriveChildrenCallback callback) {
+  std::move(callback).Run(std::move(children->data));
+}
+
 }  // namespace
 
 HDKey::HDKey()
@@ -33,8 +111,8 @@ HDKey::HDKey()
       private_key_(0),
       public_key_(33),
       chain_code_(32),
-      secp256k1_ctx_(secp256k1_context_create(SECP256K1_CONTEXT_SIGN |
-                                              SECP256K1_CONTEXT_VERIFY)) {}
+      secp256k1_ctx_(GetSecp256k1Context()),
+      derived_cache_(kDerivedCacheSize) {}
 HDKey::HDKey(uint8_t depth, uint32_t parent_fingerprint, uint32_t index)
     : depth_(depth),
       fingerprint_(0),
@@ -44,12 +122,10 @@ HDKey::HDKey(uint8_t depth, uint32_t parent_fingerprint, uint32_t index)
       private_key_(0),
       public_key_(33),
       chain_code_(32),
-      secp256k1_ctx_(secp256k1_context_create(SECP256K1_CONTEXT_SIGN |
-                                              SECP256K1_CONTEXT_VERIFY)) {}
+      secp256k1_ctx_(GetSecp256k1Context()),
+      derived_cache_(kDerivedCacheSize) {}
 
-HDKey::~HDKey() {
-  secp256k1_context_destroy(secp256k1_ctx_);
-}
+HDKey::~HDKey() = default;
 
 // static
 std::unique_ptr<HDKey> HDKey::GenerateFromSeed(
@@ -128,6 +204,7 @@ void HDKey::SetPrivateKey(const std::vector<uint8_t>& value) {
     return;
   }
   private_key_ = value;
+  derived_cache_.Clear();
   GeneratePublicKey();
   identifier_ = Hash160(public_key_);
 
@@ -156,6 +233,7 @@ void HDKey::SetPublicKey(const std::vector<uint8_t>& value) {
     return;
   }
   public_key_ = value;
+  derived_cache_.Clear();
   identifier_ = Hash160(public_key_);
 
   const uint8_t* ptr = identifier_.data();
@@ -168,6 +246,7 @@ std::string HDKey::GetPublicExtendedKey() const {
 
 void HDKey::SetChainCode(const std::vector<uint8_t>& value) {
   chain_code_ = value;
+  derived_cache_.Clear();
 }
 
 std::unique_ptr<HDKey> HDKey::DeriveChild(uint32_t index) {
@@ -250,54 +329,83 @@ std::unique_ptr<HDKey> HDKey::DeriveChild(uint32_t index) {
 }
 
 std::unique_ptr<HDKey> HDKey::DeriveChildFromPath(const std::string& path) {
-  std::unique_ptr<HDKey> hd_key = std::make_unique<HDKey>();
-  if (path == "m") {
+  std::vector<uint32_t> indexes;
+  if (!ParseDerivationPath(path, &indexes))
+    return nullptr;
+
+  // Start from the longest prefix of |path| derived before
+  std::vector<uint32_t> prefix = indexes;
+  auto it = derived_cache_.Get(prefix);
+  while (it == derived_cache_.end() && !prefix.empty()) {
+    prefix.pop_back();
+    it = derived_cache_.Get(prefix);
+  }
+  if (it == derived_cache_.end()) {
+    std::unique_ptr<HDKey> hd_key = std::make_unique<HDKey>();
     if (!private_key_.empty())
       hd_key->SetPrivateKey(private_key_);
     else
       hd_key->SetPublicKey(public_key_);
     hd_key->chain_code_ = chain_code_;
-    return hd_key;
+    it = derived_cache_.Put(prefix, std::move(hd_key));
   }
-  std::vector<std::string> entries =
-      base::SplitString(path, "/", base::WhitespaceHandling::TRIM_WHITESPACE,
-                        base::SplitResult::SPLIT_WANT_NONEMPTY);
-  if (entries.empty())
-    return nullptr;
-  for (size_t i = 0; i < entries.size(); ++i) {
-    std::string entry = entries[i];
-    if (i == 0) {
-      if (entry != "m") {
-        LOG(ERROR) << __func__ << ": path must starts with \"m\"";
-        return nullptr;
-      }
-      if (!private_key_.empty())
-        hd_key->SetPrivateKey(private_key_);
-      else
-        hd_key->SetPublicKey(public_key_);
-      hd_key->chain_code_ = chain_code_;
-      continue;
-    }
-    bool is_hardened = entry.length() > 1 && entry.back() == '\'';
-    if (is_hardened)
-      entry.pop_back();
-    unsigned child_index = 0;
-    if (!base::StringToUint(entry, &child_index)) {
-      LOG(ERROR) << __func__ << ": path must contains number or number'";
-      return nullptr;
-    }
-    if (child_index >= HARDENED_OFFSET) {
-      LOG(ERROR) << __func__ << ": index must be less than " << HARDENED_OFFSET;
-      return nullptr;
-    }
-    if (is_hardened)
-      child_index += HARDENED_OFFSET;
 
-    hd_key = hd_key->DeriveChild(child_index);
-    if (!hd_key)
-      return nullptr;
+  HDKey* parent = it->second.get();
+  for (size_t i = prefix.size(); i < indexes.size(); ++i) {
+    std::unique_ptr<HDKey> hd_key = parent->DeriveChild(indexes[i]);
+    // Leaves are rarely derived twice, so only keep intermediate keys
+    if (!hd_key || i + 1 == indexes.size())
+      return hd_key;
+    prefix.push_back(indexes[i]);
+    parent = derived_cache_.Put(prefix, std::move(hd_key))->second.get();
+  }
+  return parent->Clone();
+}
+
+std::vector<std::unique_ptr<HDKey>> HDKey::DeriveChildren(uint32_t start_index,
+                                                          size_t count) {
+  std::vector<std::unique_ptr<HDKey>> children;
+  if (!IsValidChildRange(start_index, count)) {
+    LOG(ERROR) << __func__ << ": index must be less than 2^32";
+    return children;
+  }
+  children.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    children.push_back(DeriveChild(start_index + i));
+  return children;
+}
+
+void HDKey::DeriveChildrenAsync(uint32_t start_index,
+                                size_t count,
+                                DeriveChildrenCallback callback) {
+  if (!IsValidChildRange(start_index, count)) {
+    LOG(ERROR) << __func__ << ": index must be less than 2^32";
+    std::move(callback).Run(std::vector<std::unique_ptr<HDKey>>());
+    return;
+  }
+
+  size_t num_tasks = std::min<size_t>(
+      base::SysInfo::NumberOfProcessors(),
+      (count + kMinChildrenPerTask - 1) / kMinChildrenPerTask);
+  num_tasks = std::max<size_t>(num_tasks, 1);
+  size_t children_per_task = (count + num_tasks - 1) / num_tasks;
+
+  auto children = base::MakeRefCounted<DerivedChildren>();
+  children->data.resize(count);
+  base::RepeatingClosure barrier = base::BarrierClosure(
+      num_tasks,
+      base::BindOnce(&OnChildrenDerived, children, std::move(callback)));
+  for (size_t i = 0; i < num_tasks; ++i) {
+    size_t offset = std::min(i * children_per_task, count);
+    size_t task_count = std::min(children_per_task, count - offset);
+    // Each task gets its own copy so it does not depend on this key's
+    // lifetime or touch |derived_cache_|
+    base::ThreadPool::PostTaskAndReply(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&DeriveChildrenOnThreadPool, Clone(), start_index,
+                       offset, task_count, children),
+        barrier);
   }
-  return hd_key;
 }
 
 std::vector<uint8_t> HDKey::Sign(const std::vector<uint8_t>& msg) {
@@ -351,6 +459,17 @@ bool HDKey::Verify(const std::vector<uint8_t>& msg,
   return true;
 }
 
+std::unique_ptr<HDKey> HDKey::Clone() const {
+  std::unique_ptr<HDKey> hdkey =
+      std::make_unique<HDKey>(depth_, parent_fingerprint_, index_);
+  hdkey->fingerprint_ = fingerprint_;
+  hdkey->identifier_ = identifier_;
+  hdkey->private_key_ = private_key_;
+  hdkey->public_key_ = public_key_;
+  hdkey->chain_code_ = chain_code_;
+  return hdkey;
+}
+
 void HDKey::GeneratePublicKey() {
   secp256k1_pubkey public_key;
   if (!secp256k1_ec_pubkey_create(secp256k1_ctx_, &public_key,
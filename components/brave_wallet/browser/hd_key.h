@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "brave/third_party/bitcoin-core/src/src/secp256k1/include/secp256k1.h"
 
@@ -19,10 +21,14 @@ FORWARD_DECLARE_TEST(HDKeyUnitTest, GenerateFromExtendedKey);
 FORWARD_DECLARE_TEST(HDKeyUnitTest, SetPrivateKey);
 FORWARD_DECLARE_TEST(HDKeyUnitTest, SetPublicKey);
 FORWARD_DECLARE_TEST(HDKeyUnitTest, DeriveChildFromPath);
+FORWARD_DECLARE_TEST(HDKeyUnitTest, DeriveChildFromPathCache);
 
 // This class implement basic functionality of bip32 spec
 class HDKey {
  public:
+  using DeriveChildrenCallback =
+      base::OnceCallback<void(std::vector<std::unique_ptr<HDKey>>)>;
+
   HDKey();
   HDKey(uint8_t depth, uint32_t parent_fingerprint, uint32_t index);
   ~HDKey();
@@ -52,7 +58,20 @@ class HDKey {
   // n: 0 to 2^31-1 (normal derivation)
   // n': n + 2^31 (harden derivation)
   // If path is invalid, nullptr will be returned
+  // Intermediate keys are cached, so paths sharing a prefix with an earlier
+  // call only derive the levels below that prefix
   std::unique_ptr<HDKey> DeriveChildFromPath(const std::string& path);
+  // Derives |count| consecutive children starting at |start_index|. A child
+  // which cannot be derived is nullptr, so results line up with the indexes.
+  // If the range overflows uint32_t, an empty vector will be returned
+  std::vector<std::unique_ptr<HDKey>> DeriveChildren(uint32_t start_index,
+                                                     size_t count);
+  // Same as DeriveChildren but the range is split across the thread pool and
+  // the result is replied on the calling sequence. This key may be destroyed
+  // before the reply
+  void DeriveChildrenAsync(uint32_t start_index,
+                           size_t count,
+                           DeriveChildrenCallback callback);
 
   // Sign the message using private key. The msg has to be exactly 32 bytes
   // Return 64 bytes ECDSA signature when succeed, otherwise empty vector
@@ -67,7 +86,9 @@ class HDKey {
   FRIEND_TEST_ALL_PREFIXES(HDKeyUnitTest, SetPrivateKey);
   FRIEND_TEST_ALL_PREFIXES(HDKeyUnitTest, SetPublicKey);
   FRIEND_TEST_ALL_PREFIXES(HDKeyUnitTest, DeriveChildFromPath);
+  FRIEND_TEST_ALL_PREFIXES(HDKeyUnitTest, DeriveChildFromPathCache);
 
+  std::unique_ptr<HDKey> Clone() const;
   void GeneratePublicKey();
   const std::vector<uint8_t> Hash160(const std::vector<uint8_t>& input);
   std::string Serialize(uint32_t version,
@@ -82,7 +103,12 @@ class HDKey {
   std::vector<uint8_t> public_key_;
   std::vector<uint8_t> chain_code_;
 
-  secp256k1_context* secp256k1_ctx_;
+  // Shared by all keys and only used as const, so it can be used from any
+  // thread
+  const secp256k1_context* secp256k1_ctx_;
+
+  // Derived keys keyed by their child indexes below this key
+  base::MRUCache<std::vector<uint32_t>, std::unique_ptr<HDKey>> derived_cache_;
 
   HDKey(const HDKey&) = delete;
   HDKey& operator=(const HDKey&) = delete;
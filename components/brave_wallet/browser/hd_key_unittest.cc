@@ -4,8 +4,11 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/brave_wallet/browser/hd_key.h"
+#include "base/bind.h"
+#include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/test/task_environment.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_wallet {
@@ -309,4 +312,88 @@ TEST(HDKeyUnitTest, DeriveChildFromPath) {
   }
 }
 
+TEST(HDKeyUnitTest, DeriveChildFromPathCache) {
+  std::vector<uint8_t> bytes;
+  EXPECT_TRUE(
+      base::HexStringToBytes("000102030405060708090a0b0c0d0e0f", &bytes));
+  std::unique_ptr<HDKey> m_key = HDKey::GenerateFromSeed(bytes);
+  std::unique_ptr<HDKey> uncached_key = HDKey::GenerateFromSeed(bytes);
+
+  for (const char* path :
+       {"m/0'/1/2'/2", "m/0'/1/2'/2/1000000000", "m/0'/1/2'", "m/0'", "m"}) {
+    std::unique_ptr<HDKey> key = m_key->DeriveChildFromPath(path);
+    uncached_key->derived_cache_.Clear();
+    std::unique_ptr<HDKey> expected_key =
+        uncached_key->DeriveChildFromPath(path);
+    EXPECT_EQ(key->GetPrivateExtendedKey(),
+              expected_key->GetPrivateExtendedKey());
+  }
+  // m, m/0', m/0'/1, m/0'/1/2' and m/0'/1/2'/2
+  EXPECT_EQ(m_key->derived_cache_.size(), 5u);
+
+  // Cached keys are dropped when the key changes
+  m_key->SetChainCode(std::vector<uint8_t>(32));
+  EXPECT_EQ(m_key->derived_cache_.size(), 0u);
+  EXPECT_NE(m_key->DeriveChildFromPath("m/0'")->GetPrivateExtendedKey(),
+            "xprv9uHRZZhk6KAJC1avXpDAp4MDc3sQKNxDiPvvkX8Br5ngLNv1TxvUxt4cV1"
+            "rGL5hj6KCesnDYUhd7oWgT11eZG7XnxHrnYeSvkzY7d2bhkJ7");
+}
+
+TEST(HDKeyUnitTest, DeriveChildren) {
+  std::unique_ptr<HDKey> m_key =
+      HDKey::GenerateFromSeed(std::vector<uint8_t>(32));
+  std::unique_ptr<HDKey> parent = m_key->DeriveChildFromPath("m/44'/60'/0'/0");
+
+  std::vector<std::unique_ptr<HDKey>> children =
+      parent->DeriveChildren(2147483640, 10);
+  ASSERT_EQ(children.size(), 10u);
+  for (size_t i = 0; i < children.size(); ++i) {
+    ASSERT_NE(children[i], nullptr);
+    EXPECT_EQ(children[i]->GetPrivateExtendedKey(),
+              parent->DeriveChild(2147483640 + i)->GetPrivateExtendedKey());
+  }
+
+  EXPECT_TRUE(parent->DeriveChildren(0, 0).empty());
+  EXPECT_EQ(parent->DeriveChildren(0xFFFFFFFF, 1).size(), 1u);
+  EXPECT_TRUE(parent->DeriveChildren(0xFFFFFFFF, 2).empty());
+
+  // public parent derives public children
+  std::unique_ptr<HDKey> public_parent =
+      HDKey::GenerateFromExtendedKey(parent->GetPublicExtendedKey());
+  children = public_parent->DeriveChildren(0, 2);
+  ASSERT_EQ(children.size(), 2u);
+  EXPECT_EQ(children[1]->GetPublicExtendedKey(),
+            parent->DeriveChild(1)->GetPublicExtendedKey());
+}
+
+TEST(HDKeyUnitTest, DeriveChildrenAsync) {
+  base::test::TaskEnvironment task_environment;
+  std::unique_ptr<HDKey> m_key =
+      HDKey::GenerateFromSeed(std::vector<uint8_t>(32));
+  std::unique_ptr<HDKey> parent = m_key->DeriveChildFromPath("m/44'/60'/0'/0");
+
+  for (size_t count : {0u, 1u, 100u}) {
+    base::RunLoop run_loop;
+    std::vector<std::unique_ptr<HDKey>> children;
+    parent->DeriveChildrenAsync(
+        5, count,
+        base::BindOnce(
+            [](std::vector<std::unique_ptr<HDKey>>* children,
+               base::OnceClosure quit,
+               std::vector<std::unique_ptr<HDKey>> result) {
+              *children = std::move(result);
+              std::move(quit).Run();
+            },
+            &children, run_loop.QuitClosure()));
+    run_loop.Run();
+
+    ASSERT_EQ(children.size(), count);
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_NE(children[i], nullptr);
+      EXPECT_EQ(children[i]->GetPrivateExtendedKey(),
+                parent->DeriveChild(5 + i)->GetPrivateExtendedKey());
+    }
+  }
+}
+
 }  // namespace brave_wallet
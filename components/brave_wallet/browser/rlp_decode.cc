@@ -7,183 +7,133 @@
 
 #include <utility>
 
+#include "base/check.h"
+
 namespace {
 
-// Decodes an integer
-bool RLPToInteger(const std::string& s, size_t* val) {
-  size_t length = s.length();
-  if (length == 0) {
+// Decodes a big endian length
+bool RLPToLength(base::StringPiece s, size_t* val) {
+  if (s.empty() || s.length() > sizeof(size_t)) {
     return false;
   }
-
-  if (length == 1) {
-    *val = static_cast<size_t>(static_cast<uint8_t>(s[0]));
-    return true;
-  }
-
-  size_t v2;
-  if (length <= 1 || !RLPToInteger(s.substr(0, length - 1), &v2)) {
-    return false;
+  size_t v = 0;
+  for (char c : s) {
+    v = (v << 8) | static_cast<uint8_t>(c);
   }
-  *val = static_cast<size_t>(static_cast<uint8_t>(s[length - 1]) + v2 * 256);
+  *val = v;
   return true;
 }
 
-bool IsWithinBounds(size_t offset, size_t data_len, size_t length) {
-  // This seems redundant but it is resistant to overflows
-  return offset <= length && data_len <= length && offset + data_len <= length;
-}
-
-// Decodes an offset, length, and value
-bool RLPDecodeLength(const std::string& s,
-                     size_t* offset,
-                     size_t* data_len,
-                     base::Value* value) {
-  size_t length = s.length();
-  if (length == 0) {
-    return false;
-  }
-  uint8_t prefix = static_cast<uint8_t>(s[0]);
-  if (prefix <= 0x7f) {
-    *offset = 0;
-    *data_len = 1;
-    std::string str = {s[0]};
-    *value = base::Value(str);
+bool RLPItemToValue(const brave_wallet::RLPItem& item, base::Value* output) {
+  if (!item.is_list) {
+    *output = base::Value(item.payload.as_string());
     return true;
   }
 
-  if (prefix <= 0xb7 && length > prefix - 0x80) {
-    size_t strLen = prefix - 0x80;
-    *offset = 1;
-    *data_len = strLen;
-    if (!IsWithinBounds(*offset, *data_len, length)) {
-      return false;
-    }
-    // If a string length is 1 it should have been handled by the single byte
-    // clause above.
-    if (*data_len == 1) {
+  base::ListValue list;
+  brave_wallet::RLPReader reader(item);
+  brave_wallet::RLPItem child;
+  while (reader.Next(&child)) {
+    base::Value v;
+    if (!RLPItemToValue(child, &v)) {
       return false;
     }
-    std::string str = s.substr(*offset, *data_len);
-    *value = base::Value(str);
-    return true;
+    list.Append(std::move(v));
   }
-
-  size_t i;
-  if (1 + prefix - 0xb7 <= length &&
-      RLPToInteger(s.substr(1, prefix - 0xb7), &i)) {
-    if (prefix <= 0xbf && length > prefix - 0xb7 &&
-        length > prefix - 0xb7 + i) {
-      size_t strLen = i;
-      *offset = 1 + prefix - 0xb7;
-      *data_len = strLen;
-      if (!IsWithinBounds(*offset, *data_len, length)) {
-        return false;
-      }
-      // If a list contains 0-55 bytes, it should have been handled above by
-      // the RLP encoding spec.  So this input should never happen, even though
-      // it could in theory decode properly.
-      if (*data_len <= 55) {
-        return false;
-      }
-
-      std::string str = s.substr(*offset, *data_len);
-      *value = base::Value(str);
-      return true;
-    }
+  if (reader.has_error()) {
+    return false;
   }
+  *output = std::move(list);
+  return true;
+}
 
-  if (prefix <= 0xf7 && length > prefix - 0xc0) {
-    *offset = 1;
-    *data_len = prefix - 0xc0;
-    *value = base::ListValue();
-    return true;
-  }
+}  // namespace
 
-  // The data is a list if the range of the first byte is [0xf8, 0xff], and the
-  // total payload of the list whose length is equal to the first byte minus
-  // 0xf7 follows the first byte, and the concatenation of the RLP encodings
-  // of all items of the list follows the total payload of the list;
-  size_t list_data_len;
-  size_t list_len_length = prefix - 0xf7;
-  if (prefix <= 0xff && length >= 1 + prefix - 0xf7 &&
-      RLPToInteger(s.substr(1, list_len_length), &list_data_len)) {
-    // Skip past the prefix and the list len length
-    *offset = 1 + list_len_length;
-    *data_len = list_data_len;
-    // If a list contains 0-55 elements, it should have been handled above by
-    // the RLP encoding spec.  So this input should never happen, even though
-    // it could in theory decode properly.
-    if (*data_len <= 55 || !IsWithinBounds(*offset, *data_len, length)) {
-      return false;
-    }
-    *value = base::ListValue();
-    return true;
-  }
+namespace brave_wallet {
 
-  return false;
+RLPReader::RLPReader(base::StringPiece input) : input_(input) {}
+
+RLPReader::RLPReader(const RLPItem& list) : input_(list.payload) {
+  DCHECK(list.is_list);
 }
 
-// Decodes a string and gives the result, an offset, and a data_len
-bool RLPDecodeInternal(const std::string& s,
-                       base::Value* output,
-                       size_t* offset,
-                       size_t* data_len) {
-  size_t length = s.length();
-  if (!RLPDecodeLength(s, offset, data_len, output)) {
+RLPReader::~RLPReader() = default;
+
+bool RLPReader::Next(RLPItem* item) {
+  if (has_error_ || input_.empty()) {
     return false;
   }
 
-  if (output->is_string()) {
-    if (!IsWithinBounds(*offset, *data_len, length)) {
-      return false;
-    }
-    std::string str = s.substr(*offset, *data_len);
-    *output = base::Value(str);
-  } else if (output->is_list()) {
-    *output = base::ListValue();
-    base::ListValue* output_list;
-    if (!output->GetAsList(&output_list)) {
+  const uint8_t prefix = static_cast<uint8_t>(input_[0]);
+  size_t offset;
+  size_t data_len;
+  bool is_list = false;
+  if (prefix <= 0x7f) {
+    // A single byte is its own encoding
+    offset = 0;
+    data_len = 1;
+  } else if (prefix <= 0xb7) {
+    offset = 1;
+    data_len = prefix - 0x80;
+  } else if (prefix <= 0xbf) {
+    size_t len_length = prefix - 0xb7;
+    offset = 1 + len_length;
+    // A string of 0-55 bytes should have been encoded with the short form
+    // above by the RLP encoding spec.
+    if (input_.length() < offset ||
+        !RLPToLength(input_.substr(1, len_length), &data_len) ||
+        data_len <= 55) {
+      has_error_ = true;
       return false;
     }
-    if (!IsWithinBounds(*offset, *data_len, length)) {
+  } else if (prefix <= 0xf7) {
+    is_list = true;
+    offset = 1;
+    data_len = prefix - 0xc0;
+  } else {
+    is_list = true;
+    size_t len_length = prefix - 0xf7;
+    offset = 1 + len_length;
+    // A list whose payload is 0-55 bytes should have been encoded with the
+    // short form above by the RLP encoding spec.
+    if (input_.length() < offset ||
+        !RLPToLength(input_.substr(1, len_length), &data_len) ||
+        data_len <= 55) {
+      has_error_ = true;
       return false;
     }
-    std::string sub = s.substr(*offset, *data_len);
-    while (sub.length() > 0) {
-      base::Value v;
-      size_t offset2, data_len2;
-      if (!RLPDecodeInternal(sub, &v, &offset2, &data_len2)) {
-        return false;
-      }
-      output_list->Append(std::move(v));
-      *offset += data_len2 + offset2;
-      *data_len -= data_len2 + offset2;
-      if (!IsWithinBounds(*offset, *data_len, length)) {
-        return false;
-      }
-      sub = s.substr(*offset, *data_len);
-    }
   }
 
+  // Written this way to be resistant to overflows
+  if (offset > input_.length() || data_len > input_.length() - offset) {
+    has_error_ = true;
+    return false;
+  }
+  base::StringPiece payload = input_.substr(offset, data_len);
+  // A single byte below 0x80 should have been encoded as itself
+  if (!is_list && offset == 1 && data_len == 1 &&
+      static_cast<uint8_t>(payload[0]) < 0x80) {
+    has_error_ = true;
+    return false;
+  }
+
+  item->is_list = is_list;
+  item->payload = payload;
+  input_.remove_prefix(offset + data_len);
   return true;
 }
 
-}  // namespace
-
-namespace brave_wallet {
-
 bool RLPDecode(const std::string& s, base::Value* output) {
   if (!output) {
     return false;
   }
-  size_t offset;
-  size_t data_len;
-  bool result = RLPDecodeInternal(s, output, &offset, &data_len);
-  if (!result) {
+  RLPReader reader(s);
+  RLPItem item;
+  if (!reader.Next(&item) || !RLPItemToValue(item, output)) {
     *output = base::Value();
+    return false;
   }
-  return result;
+  return true;
 }
 
 }  // namespace brave_wallet
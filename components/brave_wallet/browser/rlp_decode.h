@@ -8,10 +8,40 @@
 
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "base/values.h"
 
 namespace brave_wallet {
 
+// A single RLP item. |payload| is a view into the buffer that was read, so it
+// is only valid as long as that buffer is. For a list, |payload| holds the
+// concatenated encodings of its items and can be walked with another
+// RLPReader.
+struct RLPItem {
+  bool is_list = false;
+  base::StringPiece payload;
+};
+
+// Reads RLP items one after another from a buffer without copying them
+class RLPReader {
+ public:
+  explicit RLPReader(base::StringPiece input);
+  explicit RLPReader(const RLPItem& list);
+  ~RLPReader();
+
+  // Reads the next item into |item|. Returns false at the end of the input
+  // or when the next item is malformed, in which case has_error() is true
+  // and the reader stops.
+  bool Next(RLPItem* item);
+
+  bool has_error() const { return has_error_; }
+  bool at_end() const { return input_.empty(); }
+
+ private:
+  base::StringPiece input_;
+  bool has_error_ = false;
+};
+
 // Recursive Length Prefix (RLP) decoding of arbitrarily nested arrays of data
 // Input string should be a hex string but without the 0x prefix
 bool RLPDecode(const std::string& s, base::Value* output);
@@ -396,4 +396,74 @@ TEST(RLPDecodeTest, InvalidInputLessThanLongLengthList2) {
   ASSERT_TRUE(val.is_none());
 }
 
+TEST(RLPDecodeTest, ByteString80) {
+  base::Value val;
+  ASSERT_TRUE(RLPDecode(FromHex("0x8180"), &val));
+  std::string s;
+  ASSERT_TRUE(val.GetAsString(&s));
+  ASSERT_EQ("\x80", s);
+}
+
+TEST(RLPReaderTest, ItemsAreViewsIntoInput) {
+  std::string input = FromHex("0xcb83646f67c6836361740102");
+  RLPReader reader(input);
+  RLPItem list;
+  ASSERT_TRUE(reader.Next(&list));
+  ASSERT_TRUE(list.is_list);
+  ASSERT_TRUE(reader.at_end());
+  ASSERT_FALSE(reader.Next(&list));
+  ASSERT_FALSE(reader.has_error());
+
+  RLPReader list_reader(list);
+  RLPItem item;
+  ASSERT_TRUE(list_reader.Next(&item));
+  ASSERT_FALSE(item.is_list);
+  ASSERT_EQ("dog", item.payload);
+  ASSERT_EQ(input.data() + 2, item.payload.data());
+
+  RLPItem nested;
+  ASSERT_TRUE(list_reader.Next(&nested));
+  ASSERT_TRUE(nested.is_list);
+  ASSERT_FALSE(list_reader.Next(&item));
+  ASSERT_FALSE(list_reader.has_error());
+
+  RLPReader nested_reader(nested);
+  ASSERT_TRUE(nested_reader.Next(&item));
+  ASSERT_EQ("cat", item.payload);
+  ASSERT_TRUE(nested_reader.Next(&item));
+  ASSERT_EQ("\x01", item.payload);
+  ASSERT_TRUE(nested_reader.Next(&item));
+  ASSERT_EQ("\x02", item.payload);
+  ASSERT_EQ(input.data() + 11, item.payload.data());
+  ASSERT_FALSE(nested_reader.Next(&item));
+  ASSERT_FALSE(nested_reader.has_error());
+}
+
+TEST(RLPReaderTest, ReadsConsecutiveItems) {
+  std::string input = FromHex("0x83646f6780c0");
+  RLPReader reader(input);
+  RLPItem item;
+  ASSERT_TRUE(reader.Next(&item));
+  ASSERT_EQ("dog", item.payload);
+  ASSERT_TRUE(reader.Next(&item));
+  ASSERT_FALSE(item.is_list);
+  ASSERT_TRUE(item.payload.empty());
+  ASSERT_TRUE(reader.Next(&item));
+  ASSERT_TRUE(item.is_list);
+  ASSERT_TRUE(item.payload.empty());
+  ASSERT_FALSE(reader.Next(&item));
+  ASSERT_FALSE(reader.has_error());
+}
+
+TEST(RLPReaderTest, StopsAtMalformedItem) {
+  std::string input = FromHex("0x83646f67b840ff");
+  RLPReader reader(input);
+  RLPItem item;
+  ASSERT_TRUE(reader.Next(&item));
+  ASSERT_EQ("dog", item.payload);
+  ASSERT_FALSE(reader.Next(&item));
+  ASSERT_TRUE(reader.has_error());
+  ASSERT_FALSE(reader.Next(&item));
+}
+
 }  // namespace brave_wallet
@@ -6,72 +6,168 @@
 #include "brave/components/brave_wallet/browser/rlp_encode.h"
 
 #include <algorithm>
-#include <utility>
+#include <vector>
+
+#include "base/check_op.h"
 
 namespace {
 
-std::string RLPToBinary(size_t x) {
-  if (x == 0) {
-    return "";
+// Returns the number of bytes needed to write |x| in big endian without
+// leading zeros
+size_t RLPBinarySize(size_t x) {
+  size_t size = 0;
+  for (; x > 0; x >>= 8) {
+    ++size;
   }
-  std::string ret = RLPToBinary(x / 256);
-  ret.push_back(x % 256);
-  return ret;
+  return size;
 }
 
-std::string RLPEncodeLength(size_t length, size_t offset) {
-  char sz[2] = {0};
-  if (length < 56) {
-    sz[0] = length + offset;
-    return sz;
+size_t RLPLengthSize(size_t length) {
+  return length < 56 ? 1 : 1 + RLPBinarySize(length);
+}
+
+// Writes |input| in big endian without leading zeros to the end of |buffer|
+// and returns a view of the written bytes
+base::StringPiece RLPUint256ToBytes(brave_wallet::uint256_t input,
+                                    char (&buffer)[32]) {
+  size_t start = sizeof(buffer);
+  while (input > static_cast<brave_wallet::uint256_t>(0)) {
+    buffer[--start] = static_cast<char>(static_cast<uint8_t>(
+        input & static_cast<brave_wallet::uint256_t>(0xFF)));
+    input >>= 8;
+  }
+  return base::StringPiece(buffer + start, sizeof(buffer) - start);
+}
+
+// Gets the bytes of a string, blob or int value. |int_buffer| backs the
+// bytes of an int.
+bool GetRLPValueBytes(const base::Value& val,
+                      char (&int_buffer)[32],
+                      base::StringPiece* bytes) {
+  if (val.is_int()) {
+    *bytes = RLPUint256ToBytes(
+        static_cast<brave_wallet::uint256_t>(val.GetInt()), int_buffer);
+  } else if (val.is_blob()) {
+    const base::Value::BlobStorage& blob = val.GetBlob();
+    *bytes = base::StringPiece(reinterpret_cast<const char*>(blob.data()),
+                               blob.size());
+  } else if (val.is_string()) {
+    *bytes = val.GetString();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Returns the size of the RLP encoding of |val|. The payload sizes of the
+// lists in |val| are appended to |list_payload_sizes| in the order they are
+// written. Unsupported values are encoded as nothing.
+size_t RLPValueEncodedSize(const base::Value& val,
+                           std::vector<size_t>* list_payload_sizes) {
+  if (val.is_list()) {
+    size_t index = list_payload_sizes->size();
+    list_payload_sizes->push_back(0);
+    size_t payload_length = 0;
+    for (const auto& item : val.GetList()) {
+      payload_length += RLPValueEncodedSize(item, list_payload_sizes);
+    }
+    (*list_payload_sizes)[index] = payload_length;
+    return brave_wallet::RLPListEncodedSize(payload_length);
+  }
+  char int_buffer[32];
+  base::StringPiece bytes;
+  if (!GetRLPValueBytes(val, int_buffer, &bytes)) {
+    return 0;
+  }
+  return brave_wallet::RLPStringEncodedSize(bytes);
+}
+
+void RLPWriteValue(const base::Value& val,
+                   const std::vector<size_t>& list_payload_sizes,
+                   size_t* next_list,
+                   brave_wallet::RLPWriter* writer) {
+  if (val.is_list()) {
+    writer->WriteListHeader(list_payload_sizes[(*next_list)++]);
+    for (const auto& item : val.GetList()) {
+      RLPWriteValue(item, list_payload_sizes, next_list, writer);
+    }
+    return;
+  }
+  char int_buffer[32];
+  base::StringPiece bytes;
+  if (GetRLPValueBytes(val, int_buffer, &bytes)) {
+    writer->WriteString(bytes);
   }
-  std::string BL = RLPToBinary(length);
-  sz[0] = BL.length() + offset + 55;
-  std::string ret(sz);
-  ret.append(BL);
-  return ret;
 }
 
 }  // namespace
 
 namespace brave_wallet {
 
-base::Value RLPUint256ToBlobValue(uint256_t input) {
-  base::Value::BlobStorage output;
-  while (input > static_cast<uint256_t>(0)) {
-    uint8_t i = static_cast<uint8_t>(input & static_cast<uint256_t>(0xFF));
-    output.push_back(static_cast<char>(i));
-    input >>= 8;
+size_t RLPStringEncodedSize(base::StringPiece s) {
+  if (s.length() == 1 && static_cast<uint8_t>(s[0]) < 0x80) {
+    return 1;
   }
-  // Return the vector reversed (big endian)
-  std::reverse(output.begin(), output.end());
-  return base::Value(output);
+  return RLPLengthSize(s.length()) + s.length();
+}
+
+size_t RLPListEncodedSize(size_t payload_length) {
+  return RLPLengthSize(payload_length) + payload_length;
+}
+
+RLPWriter::RLPWriter(base::span<char> output) : output_(output) {}
+
+RLPWriter::~RLPWriter() = default;
+
+void RLPWriter::WriteString(base::StringPiece s) {
+  if (s.length() != 1 || static_cast<uint8_t>(s[0]) >= 0x80) {
+    WriteLength(s.length(), 0x80);
+  }
+  WriteBytes(s);
+}
+
+void RLPWriter::WriteListHeader(size_t payload_length) {
+  WriteLength(payload_length, 0xc0);
+}
+
+void RLPWriter::WriteLength(size_t length, uint8_t offset) {
+  if (length < 56) {
+    const char prefix = static_cast<char>(offset + length);
+    WriteBytes(base::StringPiece(&prefix, 1));
+    return;
+  }
+  char buffer[1 + sizeof(size_t)];
+  size_t binary_size = RLPBinarySize(length);
+  buffer[0] = static_cast<char>(offset + 55 + binary_size);
+  for (size_t i = binary_size; i > 0; --i, length >>= 8) {
+    buffer[i] = static_cast<char>(length & 0xFF);
+  }
+  WriteBytes(base::StringPiece(buffer, 1 + binary_size));
+}
+
+void RLPWriter::WriteBytes(base::StringPiece bytes) {
+  CHECK_LE(bytes.length(), output_.size() - position_);
+  std::copy(bytes.begin(), bytes.end(), output_.begin() + position_);
+  position_ += bytes.length();
+}
+
+base::Value RLPUint256ToBlobValue(uint256_t input) {
+  char buffer[32];
+  base::StringPiece bytes = RLPUint256ToBytes(input, buffer);
+  return base::Value(base::Value::BlobStorage(bytes.begin(), bytes.end()));
 }
 
 std::string RLPEncode(base::Value val) {
-  if (val.is_int()) {
-    int i;
-    val.GetAsInteger(&i);
-    return RLPEncode(base::Value(RLPUint256ToBlobValue((uint256_t)i)));
-  } else if (val.is_blob()) {
-    base::Value::BlobStorage blob = val.GetBlob();
-    std::string s(blob.begin(), blob.end());
-    if (blob.size() == 1 && static_cast<uint8_t>(blob[0]) < 0x80) {
-      return s;
-    }
-    return RLPEncodeLength(blob.size(), 0x80) + s;
-  } else if (val.is_string()) {
-    std::string s;
-    val.GetAsString(&s);
-    return RLPEncode(base::Value(base::Value::BlobStorage(s.begin(), s.end())));
-  } else if (val.is_list()) {
-    std::string output;
-    for (auto& item : val.GetList()) {
-      output += RLPEncode(std::move(item));
-    }
-    return RLPEncodeLength(output.length(), 0xc0) + output;
+  std::vector<size_t> list_payload_sizes;
+  std::string output(RLPValueEncodedSize(val, &list_payload_sizes), '\0');
+  if (output.empty()) {
+    return output;
   }
-  return "";
+  RLPWriter writer(base::make_span(&output[0], output.size()));
+  size_t next_list = 0;
+  RLPWriteValue(val, list_payload_sizes, &next_list, &writer);
+  DCHECK_EQ(output.size(), writer.written());
+  return output;
 }
 
 }  // namespace brave_wallet
@@ -8,11 +8,42 @@
 
 #include <string>
 
+#include "base/containers/span.h"
+#include "base/strings/string_piece.h"
 #include "base/values.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_types.h"
 
 namespace brave_wallet {
 
+// Returns the size of the RLP encoding of the byte string |s|
+size_t RLPStringEncodedSize(base::StringPiece s);
+
+// Returns the size of the RLP encoding of a list whose items encode to
+// |payload_length| bytes altogether
+size_t RLPListEncodedSize(size_t payload_length);
+
+// Writes RLP encodings into a buffer sized up front with the functions above,
+// so that the output is never reallocated. A list is written as its header
+// followed by the encodings of its items.
+class RLPWriter {
+ public:
+  explicit RLPWriter(base::span<char> output);
+  ~RLPWriter();
+
+  void WriteString(base::StringPiece s);
+  void WriteListHeader(size_t payload_length);
+
+  // Returns the number of bytes written so far
+  size_t written() const { return position_; }
+
+ private:
+  void WriteLength(size_t length, uint8_t offset);
+  void WriteBytes(base::StringPiece bytes);
+
+  base::span<char> output_;
+  size_t position_ = 0;
+};
+
 // Converts a uint256_t value into a blob value type
 base::Value RLPUint256ToBlobValue(uint256_t input);
 
@@ -391,4 +391,41 @@ TEST(RLPEncodeTest, DictionaryValueNotSupported) {
   ASSERT_TRUE(brave_wallet::RLPEncode(std::move(d)).empty());
 }
 
+TEST(RLPEncodeTest, Writer) {
+  const std::string dog = "dog";
+  const std::string cat = "cat";
+  const std::string one = {1};
+  const std::string two = {2};
+  size_t nested_length = RLPStringEncodedSize(cat) +
+                         RLPStringEncodedSize(one) + RLPStringEncodedSize(two);
+  size_t list_length =
+      RLPStringEncodedSize(dog) + RLPListEncodedSize(nested_length);
+  std::string output(RLPListEncodedSize(list_length), '\0');
+  ASSERT_EQ(12UL, output.size());
+
+  RLPWriter writer(base::make_span(&output[0], output.size()));
+  writer.WriteListHeader(list_length);
+  writer.WriteString(dog);
+  writer.WriteListHeader(nested_length);
+  writer.WriteString(cat);
+  writer.WriteString(one);
+  writer.WriteString(two);
+  ASSERT_EQ(output.size(), writer.written());
+  ASSERT_EQ(ToHex(output), "0xcb83646f67c6836361740102");
+}
+
+TEST(RLPEncodeTest, WriterLongLengths) {
+  const std::string s(1024, 'a');
+  ASSERT_EQ(1027UL, RLPStringEncodedSize(s));
+  ASSERT_EQ(1030UL, RLPListEncodedSize(RLPStringEncodedSize(s)));
+  std::string output(RLPListEncodedSize(RLPStringEncodedSize(s)), '\0');
+
+  RLPWriter writer(base::make_span(&output[0], output.size()));
+  writer.WriteListHeader(RLPStringEncodedSize(s));
+  writer.WriteString(s);
+  ASSERT_EQ(output.size(), writer.written());
+  ASSERT_EQ(ToHex(output.substr(0, 6)), "0xf90403b90400");
+  ASSERT_EQ(output.substr(6), s);
+}
+
 }  // namespace brave_wallet
@@ -5,10 +5,12 @@
 
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 
+#include <map>
 #include <memory>
 #include <utility>
 
 #include "base/bind.h"
+#include "base/no_destructor.h"
 #include "base/optional.h"
 #include "base/task/post_task.h"
 #include "brave/common/network_constants.h"
@@ -40,6 +42,12 @@ const char kSessionModelPath[] = "model";
 const char kSettingPath[] = "setting";
 const char kPerResourcePath[] = "per_resource";
 
+const ContentSettingsPattern& GetFirstPartyPattern() {
+  static const base::NoDestructor<ContentSettingsPattern> first_party(
+      ContentSettingsPattern::FromString("https://firstParty/*"));
+  return *first_party;
+}
+
 Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
   // brave plugin rules incorrectly use first party url as primary
   auto primary_pattern = reverse_patterns ? rule.secondary_pattern
@@ -47,8 +55,7 @@ Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
   auto secondary_pattern = reverse_patterns ? rule.primary_pattern
                                             : rule.secondary_pattern;
 
-  if (primary_pattern ==
-      ContentSettingsPattern::FromString("https://firstParty/*")) {
+  if (primary_pattern == GetFirstPartyPattern()) {
     DCHECK(reverse_patterns);  // we should only hit this for brave plugin rules
     if (!secondary_pattern.MatchesAllHosts()) {
       primary_pattern = ContentSettingsPattern::FromString(
@@ -66,55 +73,137 @@ Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
               rule.expiration, rule.session_model);
 }
 
+using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
+using SharedRule = base::RefCountedData<Rule>;
+using RuleMap = std::map<PatternPair,
+                         scoped_refptr<const SharedRule>,
+                         std::greater<PatternPair>>;
+
 class BraveShieldsRuleIterator : public RuleIterator {
  public:
-  explicit BraveShieldsRuleIterator(std::vector<Rule> rules)
+  using Rules =
+      base::RefCountedData<std::vector<scoped_refptr<const SharedRule>>>;
+
+  // Rules are cloned lazily as they are visited; lookups usually stop at the
+  // first match.
+  explicit BraveShieldsRuleIterator(scoped_refptr<const Rules> rules)
       : rules_(std::move(rules)) {
-    iterator_ = rules_.begin();
+    iterator_ = rules_->data.begin();
   }
 
   bool HasNext() const override {
-    return iterator_ != rules_.end();
+    return iterator_ != rules_->data.end();
   }
 
   Rule Next() override {
-    return CloneRule(*(iterator_++));
+    return CloneRule((*(iterator_++))->data);
   }
 
  private:
-  std::vector<Rule> rules_;
-  std::vector<Rule>::const_iterator iterator_;
+  scoped_refptr<const Rules> rules_;
+  std::vector<scoped_refptr<const SharedRule>>::const_iterator iterator_;
 
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsRuleIterator);
 };
 
+PatternPair GetPatternPair(const Rule& rule) {
+  return PatternPair(rule.primary_pattern, rule.secondary_pattern);
+}
+
+scoped_refptr<const SharedRule> ShareRule(Rule rule) {
+  return base::MakeRefCounted<SharedRule>(std::move(rule));
+}
 
-bool IsActive(const Rule& cookie_rule,
-              const std::vector<Rule>& shield_rules) {
+// Returns true if a shield rule for |shield_pattern| can decide whether
+// |cookie_rule| is active.
+bool ShieldPatternAppliesTo(const ContentSettingsPattern& shield_pattern,
+                            const Rule& cookie_rule) {
+  auto primary_compare = shield_pattern.Compare(cookie_rule.primary_pattern);
+  // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
+  return primary_compare == ContentSettingsPattern::IDENTITY ||
+         primary_compare == ContentSettingsPattern::SUCCESSOR;
+}
+
+bool IsActive(const Rule& cookie_rule, const RuleMap& shield_rules) {
   // don't include default rules in the iterator
   if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
       (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
-       cookie_rule.secondary_pattern ==
-          ContentSettingsPattern::FromString("https://firstParty/*"))) {
+       cookie_rule.secondary_pattern == GetFirstPartyPattern())) {
     return false;
   }
 
   bool default_value = true;
   for (const auto& shield_rule : shield_rules) {
-    auto primary_compare =
-        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
-    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
-    if (primary_compare == ContentSettingsPattern::IDENTITY ||
-        primary_compare == ContentSettingsPattern::SUCCESSOR) {
+    if (ShieldPatternAppliesTo(shield_rule.second->data.primary_pattern,
+                               cookie_rule)) {
       // TODO(bridiver) - move this logic into shields_util for allow/block
-      return
-          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
+      return ValueToContentSetting(&shield_rule.second->data.value) !=
+             CONTENT_SETTING_BLOCK;
     }
   }
 
   return default_value;
 }
 
+// Returns the cookie rule for a Brave cookie setting, or null if shields are
+// down for its site.
+scoped_refptr<const SharedRule> CompileBraveCookieRule(
+    const Rule& rule,
+    const RuleMap& shield_rules) {
+  if (!IsActive(rule, shield_rules))
+    return nullptr;
+  return ShareRule(CloneRule(rule, true));
+}
+
+// Shields down rules always override cookie rules.
+scoped_refptr<const SharedRule> CompileShieldsDownRule(
+    const Rule& shield_rule) {
+  // There is no global shields rule
+  if (shield_rule.primary_pattern.MatchesAllHosts())
+    NOTREACHED();
+
+  if (ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK)
+    return nullptr;
+
+  return ShareRule(Rule(ContentSettingsPattern::Wildcard(),
+                        shield_rule.primary_pattern,
+                        base::Value::FromUniquePtrValue(
+                            ContentSettingToValue(CONTENT_SETTING_ALLOW)),
+                        base::Time(), SessionModel::Durable));
+}
+
+// Stores |rule| under |patterns|, or removes the entry if |rule| is null.
+// If |updates| is given, the patterns of the old and new rules are added to
+// it when the setting changes.
+void ReplaceRule(RuleMap* rules,
+                 const PatternPair& patterns,
+                 scoped_refptr<const SharedRule> rule,
+                 std::vector<PatternPair>* updates) {
+  auto old_rule = rules->find(patterns);
+  if (updates) {
+    const Rule* old_data =
+        old_rule != rules->end() ? &old_rule->second->data : nullptr;
+    const bool same_patterns =
+        old_data && rule &&
+        GetPatternPair(*old_data) == GetPatternPair(rule->data);
+    if (old_data && !same_patterns)
+      updates->push_back(GetPatternPair(*old_data));
+    if (rule && (!same_patterns ||
+                 ValueToContentSetting(&rule->data.value) !=
+                     ValueToContentSetting(&old_data->value))) {
+      updates->push_back(GetPatternPair(rule->data));
+    }
+  }
+
+  if (!rule) {
+    if (old_rule != rules->end())
+      rules->erase(old_rule);
+    return;
+  }
+
+  (*rules)[patterns] = std::move(rule);
+}
+
 }  // namespace
 
 // static
@@ -365,32 +454,23 @@ bool BravePrefProvider::SetWebsiteSetting(
     std::unique_ptr<base::Value>&& in_value,
     const ContentSettingConstraints& constraints) {
   // handle changes to brave cookie settings from chromium cookie settings UI
-  if (content_type == ContentSettingsType::COOKIES) {
-    auto* value = in_value.get();
-    auto match = std::find_if(
-        brave_cookie_rules_[off_the_record_].begin(),
-        brave_cookie_rules_[off_the_record_].end(),
-        [primary_pattern, secondary_pattern, value](const auto& rule) {
-          return rule.primary_pattern == primary_pattern &&
-                 rule.secondary_pattern == secondary_pattern &&
-                 ValueToContentSetting(&rule.value) !=
-                    ValueToContentSetting(value); });
-    if (match != brave_cookie_rules_[off_the_record_].end()) {
-      // swap primary/secondary pattern - see CloneRule
-      auto plugin_primary_pattern = secondary_pattern;
-      auto plugin_secondary_pattern = primary_pattern;
-
-      // convert to legacy firstParty format for brave plugin settings
-      if (plugin_primary_pattern == plugin_secondary_pattern) {
-        plugin_secondary_pattern =
-            ContentSettingsPattern::FromString("https://firstParty/*");
-      }
-
-      // change to type ContentSettingsType::BRAVE_COOKIES
-      return SetWebsiteSettingInternal(
-          plugin_primary_pattern, plugin_secondary_pattern,
-          ContentSettingsType::BRAVE_COOKIES, std::move(in_value), constraints);
+  if (content_type == ContentSettingsType::COOKIES &&
+      HasConflictingBraveCookieRule(primary_pattern, secondary_pattern,
+                                    ValueToContentSetting(in_value.get()))) {
+    // swap primary/secondary pattern - see CloneRule
+    auto plugin_primary_pattern = secondary_pattern;
+    auto plugin_secondary_pattern = primary_pattern;
+
+    // convert to legacy firstParty format for brave plugin settings
+    if (plugin_primary_pattern == plugin_secondary_pattern) {
+      plugin_secondary_pattern =
+          ContentSettingsPattern::FromString("https://firstParty/*");
     }
+
+    // change to type ContentSettingsType::BRAVE_COOKIES
+    return SetWebsiteSettingInternal(
+        plugin_primary_pattern, plugin_secondary_pattern,
+        ContentSettingsType::BRAVE_COOKIES, std::move(in_value), constraints);
   }
 
   return SetWebsiteSettingInternal(primary_pattern, secondary_pattern,
@@ -425,13 +505,11 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
       ContentSettingsType content_type,
       bool incognito) const {
   if (content_type == ContentSettingsType::COOKIES) {
-    std::vector<Rule> rules;
-    for (auto i = cookie_rules_.at(incognito).begin();
-         i != cookie_rules_.at(incognito).end();
-         ++i) {
-      rules.emplace_back(CloneRule(*i));
+    scoped_refptr<const CookieRules> rules;
+    {
+      base::AutoLock lock(cookie_rules_lock_);
+      rules = cookie_rules_.at(incognito);
     }
-
     return std::make_unique<BraveShieldsRuleIterator>(std::move(rules));
   }
 
@@ -440,11 +518,9 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
 
 void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
                                           bool incognito) {
-  auto& rules = cookie_rules_[incognito];
-  auto old_rules = std::move(brave_cookie_rules_[incognito]);
-
-  rules.clear();
-  brave_cookie_rules_[incognito].clear();
+  CookieRuleState old_state = std::move(cookie_rule_state_[incognito]);
+  auto& state = cookie_rule_state_[incognito];
+  state = CookieRuleState();
 
   // kGoogleLoginControlType preference adds an exception for
   // accounts.google.com to access cookies in 3p context to allow login using
@@ -457,138 +533,247 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
   // are tightly bound to google, and require google auth to work.
   // See: #5075, #9852, #10367
   if (prefs_->GetBoolean(kGoogleLoginControlType)) {
-    const auto google_auth_rule = Rule(
+    state.google_rules.push_back(ShareRule(Rule(
         ContentSettingsPattern::FromString(kGoogleAuthPattern),
         ContentSettingsPattern::Wildcard(),
         base::Value::FromUniquePtrValue(
-                         ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-                     base::Time(), SessionModel::Durable);
-    rules.emplace_back(CloneRule(google_auth_rule));
-    brave_cookie_rules_[incognito].emplace_back(CloneRule(google_auth_rule));
+            ContentSettingToValue(CONTENT_SETTING_ALLOW)),
+        base::Time(), SessionModel::Durable)));
 
-    const auto firebase_rule = Rule(
+    state.google_rules.push_back(ShareRule(Rule(
         ContentSettingsPattern::FromString(kFirebasePattern),
         ContentSettingsPattern::Wildcard(),
         base::Value::FromUniquePtrValue(
             ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-        base::Time(), SessionModel::Durable);
-    rules.emplace_back(CloneRule(firebase_rule));
-    brave_cookie_rules_[incognito].emplace_back(CloneRule(firebase_rule));
+        base::Time(), SessionModel::Durable)));
   }
   // non-pref based exceptions should go in the cookie_settings_base.cc
   // chromium_src override
 
-  // add chromium cookies
-  auto chromium_cookies_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::COOKIES,
-      incognito);
-  while (chromium_cookies_iterator && chromium_cookies_iterator->HasNext()) {
-    rules.emplace_back(CloneRule(chromium_cookies_iterator->Next()));
+  // collect chromium cookies, shield settings and brave cookie settings
+  const std::pair<ContentSettingsType, RuleMap*> sources[] = {
+      {ContentSettingsType::COOKIES, &state.chromium_cookie_rules},
+      {ContentSettingsType::BRAVE_SHIELDS, &state.shield_settings},
+      {ContentSettingsType::BRAVE_COOKIES, &state.brave_cookie_settings}};
+  for (const auto& source : sources) {
+    auto rule_iterator =
+        PrefProvider::GetRuleIterator(source.first, incognito);
+    while (rule_iterator && rule_iterator->HasNext()) {
+      auto rule = rule_iterator->Next();
+      const PatternPair patterns = GetPatternPair(rule);
+      (*source.second)[patterns] = ShareRule(std::move(rule));
+    }
   }
-  chromium_cookies_iterator.reset();
 
-  auto brave_shields_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::BRAVE_SHIELDS, incognito);
+  // Matching cookie rules against shield rules.
+  for (const auto& setting : state.brave_cookie_settings) {
+    ReplaceRule(&state.brave_cookie_rules, setting.first,
+                CompileBraveCookieRule(setting.second->data,
+                                       state.shield_settings),
+                nullptr);
+  }
 
-  // collect shield rules
-  std::vector<Rule> shield_rules;
-  while (brave_shields_iterator && brave_shields_iterator->HasNext()) {
-    shield_rules.emplace_back(CloneRule(brave_shields_iterator->Next()));
+  for (const auto& shield_setting : state.shield_settings) {
+    ReplaceRule(&state.shields_down_rules, shield_setting.first,
+                CompileShieldsDownRule(shield_setting.second->data), nullptr);
   }
 
-  brave_shields_iterator.reset();
+  PublishCookieRules(incognito);
 
-  // add brave cookies after checking shield status
-  auto brave_cookies_iterator = PrefProvider::GetRuleIterator(
-      ContentSettingsType::BRAVE_COOKIES, incognito);
+  // Notify brave cookie changes as ContentSettingsType::COOKIES
+  if (!initialized_ || (content_type != ContentSettingsType::BRAVE_COOKIES &&
+                        content_type != ContentSettingsType::BRAVE_SHIELDS)) {
+    return;
+  }
 
-  // Matching cookie rules against shield rules.
-  while (brave_cookies_iterator && brave_cookies_iterator->HasNext()) {
-    auto rule = brave_cookies_iterator->Next();
-    if (IsActive(rule, shield_rules)) {
-      rules.emplace_back(CloneRule(rule, true));
-      brave_cookie_rules_[incognito].emplace_back(CloneRule(rule, true));
+  // get the list of changes. Rules are indexed by their patterns so that
+  // diffing stays cheap with thousands of per-site rules.
+  auto collect_brave_rules = [](const CookieRuleState& rule_state) {
+    std::multimap<PatternPair, ContentSetting> index;
+    for (const auto& rule : rule_state.google_rules) {
+      index.emplace(GetPatternPair(rule->data),
+                    ValueToContentSetting(&rule->data.value));
+    }
+    for (const RuleMap* rules :
+         {&rule_state.brave_cookie_rules, &rule_state.shields_down_rules}) {
+      for (const auto& rule : *rules) {
+        index.emplace(GetPatternPair(rule.second->data),
+                      ValueToContentSetting(&rule.second->data.value));
+      }
+    }
+    return index;
+  };
+  const auto old_rules_index = collect_brave_rules(old_state);
+  const auto new_rules_index = collect_brave_rules(state);
+
+  std::vector<PatternPair> brave_cookie_updates;
+  for (const auto& new_rule : new_rules_index) {
+    // we want an exact match here because any change to the rule
+    // is an update
+    const auto range = old_rules_index.equal_range(new_rule.first);
+    auto match = std::find_if(range.first, range.second,
+                              [&new_rule](const auto& old_rule) {
+                                return old_rule.second == new_rule.second;
+                              });
+    if (match == range.second) {
+      brave_cookie_updates.push_back(new_rule.first);
     }
   }
 
-  // Adding shields down rules (they always override cookie rules).
-  for (const auto& shield_rule : shield_rules) {
-    // There is no global shields rule
-    if (shield_rule.primary_pattern.MatchesAllHosts())
-      NOTREACHED();
-
-    // Shields down.
-    if (ValueToContentSetting(&shield_rule.value) == CONTENT_SETTING_BLOCK) {
-      rules.emplace_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               base::Value::FromUniquePtrValue(
-                   ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-               base::Time(), SessionModel::Durable));
-      brave_cookie_rules_[incognito].emplace_back(
-          Rule(ContentSettingsPattern::Wildcard(),
-               shield_rule.primary_pattern,
-               base::Value::FromUniquePtrValue(
-                   ContentSettingToValue(CONTENT_SETTING_ALLOW)),
-               base::Time(), SessionModel::Durable));
+  // find any removed rules
+  for (const auto& old_rule : old_rules_index) {
+    // we only care about the patterns here because we're looking
+    // for deleted rules, not changed rules
+    if (new_rules_index.count(old_rule.first) == 0) {
+      brave_cookie_updates.push_back(old_rule.first);
     }
   }
 
-  // get the list of changes
-  std::vector<Rule> brave_cookie_updates;
-  for (const auto& new_rule : brave_cookie_rules_[incognito]) {
-    auto match = std::find_if(
-        old_rules.begin(),
-        old_rules.end(),
-        [&new_rule](const auto& old_rule) {
-          // we want an exact match here because any change to the rule
-          // is an update
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern &&
-                 ValueToContentSetting(&new_rule.value) ==
-                    ValueToContentSetting(&old_rule.value);
-        });
-    if (match == old_rules.end()) {
-      brave_cookie_updates.emplace_back(CloneRule(new_rule));
+  // PostTask here to avoid content settings autolock DCHECK
+  base::PostTask(
+      FROM_HERE,
+      {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&BravePrefProvider::NotifyChanges,
+                     weak_factory_.GetWeakPtr(),
+                     std::move(brave_cookie_updates), incognito));
+}
+
+void BravePrefProvider::UpdateCookieRulesForPatterns(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type,
+    bool incognito) {
+  auto& state = cookie_rule_state_[incognito];
+  const PatternPair patterns(primary_pattern, secondary_pattern);
+  auto rule = GetPrefRule(primary_pattern, secondary_pattern, content_type,
+                          incognito);
+
+  std::vector<PatternPair> brave_cookie_updates;
+  if (content_type == ContentSettingsType::COOKIES) {
+    ReplaceRule(&state.chromium_cookie_rules, patterns, std::move(rule),
+                nullptr);
+  } else if (content_type == ContentSettingsType::BRAVE_COOKIES) {
+    ReplaceRule(&state.brave_cookie_settings, patterns, std::move(rule),
+                nullptr);
+    UpdateBraveCookieRule(&state, patterns, &brave_cookie_updates);
+  } else {
+    DCHECK_EQ(ContentSettingsType::BRAVE_SHIELDS, content_type);
+    ReplaceRule(&state.shields_down_rules, patterns,
+                rule ? CompileShieldsDownRule(rule->data) : nullptr,
+                &brave_cookie_updates);
+
+    // Only the brave cookie settings this shield rule could apply to may
+    // change state; IsActive still picks the most specific shield rule.
+    ReplaceRule(&state.shield_settings, patterns, std::move(rule), nullptr);
+    for (const auto& setting : state.brave_cookie_settings) {
+      if (ShieldPatternAppliesTo(primary_pattern, setting.second->data))
+        UpdateBraveCookieRule(&state, setting.first, &brave_cookie_updates);
     }
   }
 
-  // find any removed rules
-  for (const auto& old_rule : old_rules) {
-    auto match = std::find_if(
-        brave_cookie_rules_[incognito].begin(),
-        brave_cookie_rules_[incognito].end(),
-        [&old_rule](const auto& new_rule) {
-          // we only care about the patterns here because we're looking
-          // for deleted rules, not changed rules
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern;
-        });
-    if (match == brave_cookie_rules_[incognito].end()) {
-      brave_cookie_updates.emplace_back(
-          Rule(old_rule.primary_pattern, old_rule.secondary_pattern,
-               base::Value(), old_rule.expiration, old_rule.session_model));
+  PublishCookieRules(incognito);
+
+  if (brave_cookie_updates.empty())
+    return;
+
+  // Notify brave cookie changes as ContentSettingsType::COOKIES.
+  // PostTask here to avoid content settings autolock DCHECK
+  base::PostTask(
+      FROM_HERE,
+      {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&BravePrefProvider::NotifyChanges,
+                     weak_factory_.GetWeakPtr(),
+                     std::move(brave_cookie_updates), incognito));
+}
+
+void BravePrefProvider::UpdateBraveCookieRule(
+    CookieRuleState* state,
+    const PatternPair& patterns,
+    std::vector<PatternPair>* updates) {
+  auto setting = state->brave_cookie_settings.find(patterns);
+  ReplaceRule(&state->brave_cookie_rules, patterns,
+              setting != state->brave_cookie_settings.end()
+                  ? CompileBraveCookieRule(setting->second->data,
+                                           state->shield_settings)
+                  : nullptr,
+              updates);
+}
+
+void BravePrefProvider::PublishCookieRules(bool incognito) {
+  // Compiled into a new list and published at the end, so that iterators
+  // handed out earlier keep seeing a consistent set of rules. The rules
+  // themselves are shared with the previous list.
+  const auto& state = cookie_rule_state_[incognito];
+  auto compiled_rules = base::MakeRefCounted<CookieRules>();
+  auto& rules = compiled_rules->data;
+  rules.reserve(state.google_rules.size() +
+                state.chromium_cookie_rules.size() +
+                state.brave_cookie_rules.size() +
+                state.shields_down_rules.size());
+
+  rules.insert(rules.end(), state.google_rules.begin(),
+               state.google_rules.end());
+  for (const RuleMap* rule_map :
+       {&state.chromium_cookie_rules, &state.brave_cookie_rules,
+        &state.shields_down_rules}) {
+    for (const auto& rule : *rule_map)
+      rules.push_back(rule.second);
+  }
+
+  base::AutoLock lock(cookie_rules_lock_);
+  cookie_rules_[incognito] = std::move(compiled_rules);
+}
+
+scoped_refptr<const BravePrefProvider::SharedRule>
+BravePrefProvider::GetPrefRule(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type,
+                               bool incognito) const {
+  // PrefProvider can't look up a single pattern pair, so walk the rules of
+  // this one type.
+  auto rule_iterator = PrefProvider::GetRuleIterator(content_type, incognito);
+  while (rule_iterator && rule_iterator->HasNext()) {
+    auto rule = rule_iterator->Next();
+    if (rule.primary_pattern == primary_pattern &&
+        rule.secondary_pattern == secondary_pattern) {
+      return ShareRule(std::move(rule));
     }
   }
+  return nullptr;
+}
 
-  // Notify brave cookie changes as ContentSettingsType::COOKIES
-  if (initialized_ && (content_type == ContentSettingsType::BRAVE_COOKIES ||
-                       content_type == ContentSettingsType::BRAVE_SHIELDS)) {
-    // PostTask here to avoid content settings autolock DCHECK
-    base::PostTask(
-        FROM_HERE,
-        {content::BrowserThread::UI, base::TaskPriority::USER_VISIBLE},
-        base::BindOnce(&BravePrefProvider::NotifyChanges,
-                       weak_factory_.GetWeakPtr(),
-                       std::move(brave_cookie_updates), incognito));
+bool BravePrefProvider::HasConflictingBraveCookieRule(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSetting setting) const {
+  auto state = cookie_rule_state_.find(off_the_record_);
+  if (state == cookie_rule_state_.end())
+    return false;
+
+  auto conflicts = [&](const Rule& rule) {
+    return rule.primary_pattern == primary_pattern &&
+           rule.secondary_pattern == secondary_pattern &&
+           ValueToContentSetting(&rule.value) != setting;
+  };
+
+  for (const auto& rule : state->second.google_rules) {
+    if (conflicts(rule->data))
+      return true;
+  }
+  for (const RuleMap* rules : {&state->second.brave_cookie_rules,
+                               &state->second.shields_down_rules}) {
+    for (const auto& rule : *rules) {
+      if (conflicts(rule.second->data))
+        return true;
+    }
   }
+  return false;
 }
 
-void BravePrefProvider::NotifyChanges(const std::vector<Rule>& rules,
+void BravePrefProvider::NotifyChanges(const std::vector<PatternPair>& updates,
                                       bool incognito) {
-  for (const auto& rule : rules) {
-    Notify(rule.primary_pattern, rule.secondary_pattern,
-           ContentSettingsType::COOKIES);
+  for (const auto& patterns : updates) {
+    Notify(patterns.first, patterns.second, ContentSettingsType::COOKIES);
   }
 }
 
@@ -607,11 +792,29 @@ void BravePrefProvider::OnContentSettingChanged(
     const ContentSettingsPattern& primary_pattern,
     const ContentSettingsPattern& secondary_pattern,
     ContentSettingsType content_type) {
-  if (content_type == ContentSettingsType::COOKIES ||
-      content_type == ContentSettingsType::BRAVE_COOKIES ||
-      content_type == ContentSettingsType::BRAVE_SHIELDS) {
+  if (content_type != ContentSettingsType::COOKIES &&
+      content_type != ContentSettingsType::BRAVE_COOKIES &&
+      content_type != ContentSettingsType::BRAVE_SHIELDS) {
+    return;
+  }
+
+  // Invalid patterns mean that every setting of the type may have changed.
+  if (!primary_pattern.IsValid() || !secondary_pattern.IsValid()) {
     OnCookieSettingsChanged(content_type);
+    return;
   }
+
+  UpdateCookieRulesForPatterns(primary_pattern, secondary_pattern,
+                               content_type, true);
+  UpdateCookieRulesForPatterns(primary_pattern, secondary_pattern,
+                               content_type, false);
 }
 
+BravePrefProvider::CookieRuleState::CookieRuleState() = default;
+BravePrefProvider::CookieRuleState::CookieRuleState(CookieRuleState&&) =
+    default;
+BravePrefProvider::CookieRuleState&
+BravePrefProvider::CookieRuleState::operator=(CookieRuleState&&) = default;
+BravePrefProvider::CookieRuleState::~CookieRuleState() = default;
+
 }  // namespace content_settings
@@ -6,12 +6,16 @@
 #ifndef BRAVE_COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_BRAVE_CONTENT_SETTINGS_PREF_PROVIDER_H_
 #define BRAVE_COMPONENTS_CONTENT_SETTINGS_CORE_BROWSER_BRAVE_CONTENT_SETTINGS_PREF_PROVIDER_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/synchronization/lock.h"
 #include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_pref_provider.h"
 #include "components/prefs/pref_change_registrar.h"
@@ -51,6 +55,34 @@ class BravePrefProvider : public PrefProvider,
                            TestShieldsSettingsMigrationFromResourceIDs);
   FRIEND_TEST_ALL_PREFIXES(BravePrefProviderTest,
                            TestShieldsSettingsMigrationFromUnknownSettings);
+
+  using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
+  using SharedRule = base::RefCountedData<Rule>;
+  // Keyed by the patterns of the source setting and ordered like upstream's
+  // rule iterators, most specific patterns first.
+  using RuleMap = std::map<PatternPair,
+                           scoped_refptr<const SharedRule>,
+                           std::greater<PatternPair>>;
+
+  // The settings the cookie rules are compiled from and the rules compiled
+  // from each of them, so that a change to one setting only recompiles the
+  // rules that depend on it.
+  struct CookieRuleState {
+    CookieRuleState();
+    CookieRuleState(CookieRuleState&&);
+    CookieRuleState& operator=(CookieRuleState&&);
+    ~CookieRuleState();
+
+    std::vector<scoped_refptr<const SharedRule>> google_rules;
+    RuleMap chromium_cookie_rules;
+    RuleMap brave_cookie_settings;
+    RuleMap shield_settings;
+    // Brave cookie settings whose site has shields up.
+    RuleMap brave_cookie_rules;
+    // Allow-all rules for sites with shields down.
+    RuleMap shields_down_rules;
+  };
+
   void MigrateShieldsSettings(bool incognito);
   void MigrateShieldsSettingsFromResourceIds();
   void MigrateShieldsSettingsFromResourceIdsForOneType(
@@ -63,8 +95,26 @@ class BravePrefProvider : public PrefProvider,
   void MigrateShieldsSettingsV1ToV2();
   void MigrateShieldsSettingsV1ToV2ForOneType(ContentSettingsType content_type);
   void UpdateCookieRules(ContentSettingsType content_type, bool incognito);
+  void UpdateCookieRulesForPatterns(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSettingsType content_type,
+      bool incognito);
+  void UpdateBraveCookieRule(CookieRuleState* state,
+                             const PatternPair& patterns,
+                             std::vector<PatternPair>* updates);
+  void PublishCookieRules(bool incognito);
+  scoped_refptr<const SharedRule> GetPrefRule(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSettingsType content_type,
+      bool incognito) const;
+  bool HasConflictingBraveCookieRule(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSetting setting) const;
   void OnCookieSettingsChanged(ContentSettingsType content_type);
-  void NotifyChanges(const std::vector<Rule>& rules, bool incognito);
+  void NotifyChanges(const std::vector<PatternPair>& updates, bool incognito);
   bool SetWebsiteSettingInternal(
       const ContentSettingsPattern& primary_pattern,
       const ContentSettingsPattern& secondary_pattern,
@@ -78,8 +128,15 @@ class BravePrefProvider : public PrefProvider,
                                ContentSettingsType content_type) override;
   void OnCookiePrefsChanged(const std::string& pref);
 
-  std::map<bool /* is_incognito */, std::vector<Rule>> cookie_rules_;
-  std::map<bool /* is_incognito */, std::vector<Rule>> brave_cookie_rules_;
+  // Compiled cookie rules are immutable once published, so rule iterators
+  // (which may be created off the UI thread) share them instead of copying
+  // every rule. |cookie_rules_lock_| only guards swapping the pointers.
+  using CookieRules =
+      base::RefCountedData<std::vector<scoped_refptr<const SharedRule>>>;
+  mutable base::Lock cookie_rules_lock_;
+  std::map<bool /* is_incognito */, scoped_refptr<const CookieRules>>
+      cookie_rules_;
+  std::map<bool /* is_incognito */, CookieRuleState> cookie_rule_state_;
 
   bool initialized_;
   bool store_last_modified_;
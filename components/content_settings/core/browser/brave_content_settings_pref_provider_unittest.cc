@@ -3,8 +3,11 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/optional.h"
@@ -524,4 +527,115 @@ TEST_F(BravePrefProviderTest, TestShieldsSettingsMigrationFromUnknownSettings) {
   provider.ShutdownOnUIThread();
 }
 
+TEST_F(BravePrefProviderTest, CookieRuleIteratorKeepsSnapshot) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  auto count_rules = [](std::unique_ptr<RuleIterator> rule_iterator) {
+    size_t count = 0;
+    while (rule_iterator && rule_iterator->HasNext()) {
+      rule_iterator->Next();
+      count++;
+    }
+    return count;
+  };
+
+  const size_t initial_count = count_rules(
+      provider.GetRuleIterator(ContentSettingsType::COOKIES, false));
+  auto old_iterator =
+      provider.GetRuleIterator(ContentSettingsType::COOKIES, false);
+
+  provider.SetWebsiteSetting(
+      ContentSettingsPattern::FromString("[*.]brave.com"),
+      ContentSettingsPattern::Wildcard(), ContentSettingsType::COOKIES,
+      ContentSettingToValue(CONTENT_SETTING_BLOCK), {});
+
+  // Iterators handed out before the change keep the old rules.
+  EXPECT_EQ(initial_count, count_rules(std::move(old_iterator)));
+  EXPECT_EQ(initial_count + 1,
+            count_rules(
+                provider.GetRuleIterator(ContentSettingsType::COOKIES, false)));
+
+  provider.ShutdownOnUIThread();
+}
+
+TEST_F(BravePrefProviderTest, CookieRuleUpdatesMatchFullRebuild) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  auto dump_rules = [](std::unique_ptr<RuleIterator> rule_iterator) {
+    std::vector<std::string> rules;
+    while (rule_iterator && rule_iterator->HasNext()) {
+      auto rule = rule_iterator->Next();
+      rules.push_back(rule.primary_pattern.ToString() + "," +
+                      rule.secondary_pattern.ToString() + "," +
+                      base::NumberToString(ValueToContentSetting(&rule.value)));
+    }
+    return rules;
+  };
+
+  // A new provider compiles every cookie rule from the prefs.
+  auto rebuilt_rules = [&]() {
+    BravePrefProvider rebuilt_provider(
+        testing_profile()->GetPrefs(), false /* incognito */,
+        true /* store_last_modified */, false /* restore_session */);
+    auto rules = dump_rules(
+        rebuilt_provider.GetRuleIterator(ContentSettingsType::COOKIES, false));
+    rebuilt_provider.ShutdownOnUIThread();
+    return rules;
+  };
+
+  const auto brave_pattern =
+      ContentSettingsPattern::FromString("[*.]brave.com");
+  const auto example_pattern =
+      ContentSettingsPattern::FromString("[*.]example.com");
+  const auto first_party_pattern =
+      ContentSettingsPattern::FromString("https://firstParty/*");
+  const auto allow_brave_cookies_rule =
+      "*," + brave_pattern.ToString() + "," +
+      base::NumberToString(CONTENT_SETTING_ALLOW);
+
+  auto set_setting = [&](const ContentSettingsPattern& primary_pattern,
+                         const ContentSettingsPattern& secondary_pattern,
+                         ContentSettingsType content_type,
+                         ContentSetting setting) {
+    provider.SetWebsiteSetting(primary_pattern, secondary_pattern,
+                               content_type, ContentSettingToValue(setting),
+                               {});
+    EXPECT_EQ(rebuilt_rules(),
+              dump_rules(provider.GetRuleIterator(ContentSettingsType::COOKIES,
+                                                  false)));
+  };
+
+  set_setting(brave_pattern, first_party_pattern,
+              ContentSettingsType::BRAVE_COOKIES, CONTENT_SETTING_BLOCK);
+  set_setting(example_pattern, ContentSettingsPattern::Wildcard(),
+              ContentSettingsType::BRAVE_COOKIES, CONTENT_SETTING_BLOCK);
+  set_setting(ContentSettingsPattern::FromString("[*.]example.org"),
+              ContentSettingsPattern::Wildcard(), ContentSettingsType::COOKIES,
+              CONTENT_SETTING_BLOCK);
+
+  // Shields down drops the site's cookie rules in favor of allowing all.
+  set_setting(brave_pattern, ContentSettingsPattern::Wildcard(),
+              ContentSettingsType::BRAVE_SHIELDS, CONTENT_SETTING_BLOCK);
+  auto rules =
+      dump_rules(provider.GetRuleIterator(ContentSettingsType::COOKIES, false));
+  EXPECT_NE(rules.end(),
+            std::find(rules.begin(), rules.end(), allow_brave_cookies_rule));
+
+  set_setting(brave_pattern, ContentSettingsPattern::Wildcard(),
+              ContentSettingsType::BRAVE_SHIELDS, CONTENT_SETTING_DEFAULT);
+  rules =
+      dump_rules(provider.GetRuleIterator(ContentSettingsType::COOKIES, false));
+  EXPECT_EQ(rules.end(),
+            std::find(rules.begin(), rules.end(), allow_brave_cookies_rule));
+
+  set_setting(example_pattern, ContentSettingsPattern::Wildcard(),
+              ContentSettingsType::BRAVE_COOKIES, CONTENT_SETTING_DEFAULT);
+
+  provider.ShutdownOnUIThread();
+}
+
 }  //  namespace content_settings
@@ -32,6 +32,10 @@
 namespace content_settings {
 namespace {
 
+// Bumped whenever the renderer receives new content setting rules. All agents
+// of the renderer share the same rules.
+uint64_t g_content_setting_rules_generation = 0;
+
 bool IsFrameWithOpaqueOrigin(blink::WebFrame* frame) {
   // Storage access is keyed off the top origin and the frame's origin.
   // It will be denied any opaque origins so have this method to return early
@@ -99,10 +103,17 @@ void BraveContentSettingsAgentImpl::OnAllowScriptsOnce(
   preloaded_temporarily_allowed_scripts_ = std::move(origins);
 }
 
+// static
+void BraveContentSettingsAgentImpl::OnContentSettingRulesUpdated() {
+  g_content_setting_rules_generation++;
+}
+
 void BraveContentSettingsAgentImpl::DidCommitProvisionalLoad(
     ui::PageTransition transition) {
   temporarily_allowed_scripts_ =
       std::move(preloaded_temporarily_allowed_scripts_);
+  cached_shields_down_.reset();
+  cached_farbling_level_.reset();
   ContentSettingsAgentImpl::DidCommitProvisionalLoad(transition);
 }
 
@@ -245,43 +256,59 @@ bool BraveContentSettingsAgentImpl::IsBraveShieldsDown(
              frame, secondary_url, content_setting_rules_->brave_shields_rules);
 }
 
-bool BraveContentSettingsAgentImpl::AllowFingerprinting(
-    bool enabled_per_settings) {
-  if (!enabled_per_settings)
-    return false;
-  blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
-  const GURL secondary_url(url::Origin(frame->GetSecurityOrigin()).GetURL());
-  if (IsBraveShieldsDown(frame, secondary_url)) {
-    return true;
+void BraveContentSettingsAgentImpl::EnsureFarblingStateCached() {
+  if (cached_rules_generation_ != g_content_setting_rules_generation) {
+    cached_shields_down_.reset();
+    cached_farbling_level_.reset();
   }
 
-  return GetBraveFarblingLevel() != BraveFarblingLevel::MAXIMUM;
-}
+  // Rules arrive shortly after the frame is created; don't cache the
+  // defaults until they do.
+  if (cached_farbling_level_ || !content_setting_rules_)
+    return;
 
-BraveFarblingLevel BraveContentSettingsAgentImpl::GetBraveFarblingLevel() {
   blink::WebLocalFrame* frame = render_frame()->GetWebFrame();
+  const bool shields_down = IsBraveShieldsDown(
+      frame, url::Origin(frame->GetSecurityOrigin()).GetURL());
 
-  ContentSetting setting = CONTENT_SETTING_DEFAULT;
-  if (content_setting_rules_) {
-    if (IsBraveShieldsDown(frame,
-                           url::Origin(frame->GetSecurityOrigin()).GetURL())) {
-      setting = CONTENT_SETTING_ALLOW;
-    } else {
-      setting = GetBraveFPContentSettingFromRules(
-          content_setting_rules_->fingerprinting_rules, GetOriginOrURL(frame));
-    }
+  ContentSetting setting = CONTENT_SETTING_ALLOW;
+  if (!shields_down) {
+    setting = GetBraveFPContentSettingFromRules(
+        content_setting_rules_->fingerprinting_rules, GetOriginOrURL(frame));
   }
 
+  BraveFarblingLevel level;
   if (setting == CONTENT_SETTING_BLOCK) {
     VLOG(1) << "farbling level MAXIMUM";
-    return BraveFarblingLevel::MAXIMUM;
+    level = BraveFarblingLevel::MAXIMUM;
   } else if (setting == CONTENT_SETTING_ALLOW) {
     VLOG(1) << "farbling level OFF";
-    return BraveFarblingLevel::OFF;
+    level = BraveFarblingLevel::OFF;
   } else {
     VLOG(1) << "farbling level BALANCED";
-    return BraveFarblingLevel::BALANCED;
+    level = BraveFarblingLevel::BALANCED;
   }
+
+  cached_shields_down_ = shields_down;
+  cached_farbling_level_ = level;
+  cached_rules_generation_ = g_content_setting_rules_generation;
+}
+
+bool BraveContentSettingsAgentImpl::AllowFingerprinting(
+    bool enabled_per_settings) {
+  if (!enabled_per_settings)
+    return false;
+  EnsureFarblingStateCached();
+  // Without rules shields are treated as down.
+  if (cached_shields_down_.value_or(true))
+    return true;
+
+  return GetBraveFarblingLevel() != BraveFarblingLevel::MAXIMUM;
+}
+
+BraveFarblingLevel BraveContentSettingsAgentImpl::GetBraveFarblingLevel() {
+  EnsureFarblingStateCached();
+  return cached_farbling_level_.value_or(BraveFarblingLevel::BALANCED);
 }
 
 bool BraveContentSettingsAgentImpl::AllowAutoplay(bool play_requested) {
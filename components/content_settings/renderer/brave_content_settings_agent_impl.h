@@ -13,6 +13,7 @@
 
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/optional.h"
 #include "base/strings/string16.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "components/content_settings/core/common/content_settings.h"
@@ -34,6 +35,10 @@ class BraveContentSettingsAgentImpl : public ContentSettingsAgentImpl {
                                 std::unique_ptr<Delegate> delegate);
   ~BraveContentSettingsAgentImpl() override;
 
+  // Called when the renderer receives new content setting rules, which drops
+  // the state every agent cached from the previous rules.
+  static void OnContentSettingRulesUpdated();
+
  protected:
   bool AllowScript(bool enabled_per_settings) override;
   bool AllowScriptFromSource(bool enabled_per_settings,
@@ -62,6 +67,10 @@ class BraveContentSettingsAgentImpl : public ContentSettingsAgentImpl {
       const blink::WebFrame* frame,
       const GURL& secondary_url);
 
+  // Resolves the shields state and farbling level of the committed document
+  // once and caches them until the next commit or rules update.
+  void EnsureFarblingStateCached();
+
   // RenderFrameObserver
   bool OnMessageReceived(const IPC::Message& message) override;
   void OnAllowScriptsOnce(const std::vector<std::string>& origins);
@@ -83,6 +92,14 @@ class BraveContentSettingsAgentImpl : public ContentSettingsAgentImpl {
   using StoragePermissionsKey = std::pair<url::Origin, StorageType>;
   base::flat_map<StoragePermissionsKey, bool> cached_storage_permissions_;
 
+  // Shields state and farbling level of the current document. The browser
+  // pushes updated rules before each navigation commits, so these are reset
+  // in `DidCommitProvisionalLoad()`. Rules can also change while a document
+  // is loaded, which `cached_rules_generation_` catches.
+  base::Optional<bool> cached_shields_down_;
+  base::Optional<BraveFarblingLevel> cached_farbling_level_;
+  uint64_t cached_rules_generation_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(BraveContentSettingsAgentImpl);
 };
 
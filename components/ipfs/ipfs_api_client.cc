@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_api_client.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/cpp/shared_url_loader_factory.h"
+#include "services/network/public/cpp/simple_url_loader.h"
+
+namespace {
+
+// brave://ipfs refreshes every 2 seconds. Staying below that keeps a single
+// page seeing new values on every refresh while pages refreshing at the same
+// time share them.
+const int kCacheTTLMs = 1500;
+
+}  // namespace
+
+namespace ipfs {
+
+IpfsAPIClient::PendingRequest::PendingRequest() = default;
+IpfsAPIClient::PendingRequest::PendingRequest(PendingRequest&&) = default;
+IpfsAPIClient::PendingRequest& IpfsAPIClient::PendingRequest::operator=(
+    PendingRequest&&) = default;
+IpfsAPIClient::PendingRequest::~PendingRequest() = default;
+
+IpfsAPIClient::IpfsAPIClient(
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
+    CreateURLLoaderCallback create_url_loader)
+    : url_loader_factory_(std::move(url_loader_factory)),
+      create_url_loader_(std::move(create_url_loader)),
+      cache_ttl_(base::TimeDelta::FromMilliseconds(kCacheTTLMs)) {}
+
+IpfsAPIClient::~IpfsAPIClient() = default;
+
+void IpfsAPIClient::Read(const GURL& url, ResponseCallback callback) {
+  auto cached = cache_.find(url);
+  if (cached != cache_.end()) {
+    if (base::TimeTicks::Now() - cached->second.time < cache_ttl_) {
+      // Reply asynchronously like a request would. Like the callbacks of a
+      // request, the reply is dropped if the client is destroyed first.
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&IpfsAPIClient::RunCachedResponse,
+                                    weak_factory_.GetWeakPtr(),
+                                    std::move(callback), cached->second.body));
+      return;
+    }
+    cache_.erase(cached);
+  }
+
+  for (auto& request : pending_requests_) {
+    if (request.is_read && request.url == url &&
+        request.cache_generation == cache_generation_) {
+      request.callbacks.push_back(std::move(callback));
+      return;
+    }
+  }
+
+  Send(url, true, std::move(callback));
+}
+
+void IpfsAPIClient::Write(const GURL& url, ResponseCallback callback) {
+  Send(url, false, std::move(callback));
+}
+
+void IpfsAPIClient::ClearCache() {
+  cache_.clear();
+  cache_generation_++;
+}
+
+void IpfsAPIClient::SetCacheTTLForTest(base::TimeDelta ttl) {
+  cache_ttl_ = ttl;
+}
+
+void IpfsAPIClient::RunCachedResponse(ResponseCallback callback,
+                                      const std::string& body) {
+  std::move(callback).Run(net::OK, net::HTTP_OK, body);
+}
+
+void IpfsAPIClient::Send(const GURL& url,
+                         bool is_read,
+                         ResponseCallback callback) {
+  PendingRequest request;
+  request.url = url;
+  request.is_read = is_read;
+  request.cache_generation = cache_generation_;
+  request.url_loader = create_url_loader_.Run(url);
+  request.callbacks.push_back(std::move(callback));
+  auto iter =
+      pending_requests_.insert(pending_requests_.begin(), std::move(request));
+
+  iter->url_loader->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+      url_loader_factory_.get(),
+      base::BindOnce(&IpfsAPIClient::OnResponse, base::Unretained(this),
+                     iter));
+}
+
+void IpfsAPIClient::OnResponse(PendingRequestList::iterator iter,
+                               std::unique_ptr<std::string> response_body) {
+  auto* url_loader = iter->url_loader.get();
+  int error_code = url_loader->NetError();
+  int response_code = -1;
+  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
+    response_code = url_loader->ResponseInfo()->headers->response_code();
+  PendingRequest request = std::move(*iter);
+  pending_requests_.erase(iter);
+
+  std::string body;
+  if (response_body)
+    body = std::move(*response_body);
+
+  if (error_code == net::OK && response_code == net::HTTP_OK) {
+    if (request.is_read) {
+      // A read which was in flight when the cache was cleared may return
+      // what a write has changed since
+      if (request.cache_generation == cache_generation_)
+        cache_[request.url] = {body, base::TimeTicks::Now()};
+    } else {
+      // The write may have changed anything a read returns
+      ClearCache();
+    }
+  }
+
+  for (auto& callback : request.callbacks)
+    std::move(callback).Run(error_code, response_code, body);
+}
+
+}  // namespace ipfs
@@ -0,0 +1,100 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_IPFS_IPFS_API_CLIENT_H_
+#define BRAVE_COMPONENTS_IPFS_IPFS_API_CLIENT_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "url/gurl.h"
+
+namespace network {
+class SharedURLLoaderFactory;
+class SimpleURLLoader;
+}  // namespace network
+
+namespace ipfs {
+
+// Sends requests to the HTTP API of the local IPFS daemon. Concurrent reads of
+// the same URL share one request, and successful reads are reused for a short
+// time, so several brave://ipfs pages polling the daemon are answered by the
+// same round trips.
+class IpfsAPIClient {
+ public:
+  // |error_code| is a net error and |response_code| is -1 if no response
+  // headers were received.
+  using ResponseCallback = base::OnceCallback<
+      void(int error_code, int response_code, const std::string& body)>;
+  using CreateURLLoaderCallback =
+      base::RepeatingCallback<std::unique_ptr<network::SimpleURLLoader>(
+          const GURL& url)>;
+
+  IpfsAPIClient(
+      scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
+      CreateURLLoaderCallback create_url_loader);
+  ~IpfsAPIClient();
+
+  // Reads |url|, from the cache if it was read recently.
+  void Read(const GURL& url, ResponseCallback callback);
+  // Sends a request that changes the state of the daemon. It is never shared
+  // with other requests and drops all cached reads once it succeeds.
+  void Write(const GURL& url, ResponseCallback callback);
+
+  void ClearCache();
+
+  void SetCacheTTLForTest(base::TimeDelta ttl);
+
+ private:
+  struct PendingRequest {
+    PendingRequest();
+    PendingRequest(PendingRequest&&);
+    PendingRequest& operator=(PendingRequest&&);
+    ~PendingRequest();
+
+    GURL url;
+    bool is_read = false;
+    // |cache_generation_| when the request was sent.
+    uint64_t cache_generation = 0;
+    std::unique_ptr<network::SimpleURLLoader> url_loader;
+    std::vector<ResponseCallback> callbacks;
+  };
+  using PendingRequestList = std::list<PendingRequest>;
+
+  struct CachedResponse {
+    std::string body;
+    base::TimeTicks time;
+  };
+
+  void RunCachedResponse(ResponseCallback callback, const std::string& body);
+  void Send(const GURL& url, bool is_read, ResponseCallback callback);
+  void OnResponse(PendingRequestList::iterator iter,
+                  std::unique_ptr<std::string> response_body);
+
+  scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
+  CreateURLLoaderCallback create_url_loader_;
+  PendingRequestList pending_requests_;
+  std::map<GURL, CachedResponse> cache_;
+  // Bumped whenever |cache_| is cleared, so that reads sent before then are
+  // neither cached nor shared.
+  uint64_t cache_generation_ = 0;
+  base::TimeDelta cache_ttl_;
+
+  base::WeakPtrFactory<IpfsAPIClient> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(IpfsAPIClient);
+};
+
+}  // namespace ipfs
+
+#endif  // BRAVE_COMPONENTS_IPFS_IPFS_API_CLIENT_H_
@@ -0,0 +1,121 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ipfs/ipfs_api_client.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "net/base/net_errors.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/simple_url_loader.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace {
+
+std::unique_ptr<network::SimpleURLLoader> CreateURLLoader(const GURL& url) {
+  auto request = std::make_unique<network::ResourceRequest>();
+  request->url = url;
+  request->method = "POST";
+  return network::SimpleURLLoader::Create(std::move(request),
+                                          TRAFFIC_ANNOTATION_FOR_TESTS);
+}
+
+}  // namespace
+
+namespace ipfs {
+
+class IpfsAPIClientTest : public testing::Test {
+ public:
+  IpfsAPIClientTest()
+      : api_client_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_),
+            base::BindRepeating(&CreateURLLoader)) {}
+
+ protected:
+  // Reads |url| and stores the response body in |body|.
+  void Read(const GURL& url, std::string* body) {
+    api_client_.Read(url, base::BindOnce(
+                              [](std::string* body, int error_code,
+                                 int response_code, const std::string& result) {
+                                *body = result;
+                              },
+                              body));
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  IpfsAPIClient api_client_;
+};
+
+TEST_F(IpfsAPIClientTest, ReadBeforeWriteIsNotCached) {
+  const GURL read_url("http://127.0.0.1:45001/api/v0/repo/stat");
+  const GURL write_url("http://127.0.0.1:45001/api/v0/repo/gc");
+
+  std::string first_body;
+  Read(read_url, &first_body);
+  api_client_.Write(write_url, base::DoNothing());
+
+  // The write completes while the earlier read is still in flight.
+  url_loader_factory_.SimulateResponseForPendingRequest(write_url.spec(), "");
+  task_environment_.RunUntilIdle();
+
+  // A read sent after the write does not share the earlier one.
+  std::string second_body;
+  Read(read_url, &second_body);
+  EXPECT_EQ(url_loader_factory_.NumPending(), 2);
+
+  url_loader_factory_.SimulateResponseForPendingRequest(read_url.spec(),
+                                                        "before");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(first_body, "before");
+  EXPECT_EQ(second_body, "");
+
+  url_loader_factory_.SimulateResponseForPendingRequest(read_url.spec(),
+                                                        "after");
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(second_body, "after");
+
+  // Only the read sent after the write is cached.
+  std::string cached_body;
+  Read(read_url, &cached_body);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(url_loader_factory_.NumPending(), 0);
+  EXPECT_EQ(cached_body, "after");
+}
+
+TEST_F(IpfsAPIClientTest, CachedReadDroppedWithClient) {
+  const GURL url("http://127.0.0.1:45001/api/v0/id");
+  auto api_client = std::make_unique<IpfsAPIClient>(
+      base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+          &url_loader_factory_),
+      base::BindRepeating(&CreateURLLoader));
+
+  bool called = false;
+  auto callback = [](bool* called, int error_code, int response_code,
+                     const std::string& body) { *called = true; };
+  api_client->Read(url, base::BindOnce(callback, &called));
+  url_loader_factory_.SimulateResponseForPendingRequest(url.spec(), "{}");
+  task_environment_.RunUntilIdle();
+  ASSERT_TRUE(called);
+
+  // The cached reply is posted, and must not run once the client is gone.
+  called = false;
+  api_client->Read(url, base::BindOnce(callback, &called));
+  EXPECT_EQ(url_loader_factory_.NumPending(), 0);
+  api_client.reset();
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(called);
+}
+
+}  // namespace ipfs
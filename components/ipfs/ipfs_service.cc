@@ -14,7 +14,9 @@
 #include "base/strings/strcat.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
+#include "base/task/thread_pool.h"
 #include "base/task_runner_util.h"
+#include "brave/components/ipfs/ipfs_api_client.h"
 #include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_json_parser.h"
 #include "brave/components/ipfs/ipfs_ports.h"
@@ -80,6 +82,31 @@ std::pair<bool, std::string> LoadConfigFileOnFileTaskRunner(
   return result;
 }
 
+// Responses can be large, such as the peers of a well connected node, so they
+// are parsed off the UI thread
+template <typename T>
+std::pair<bool, T> ParseJSONOnThreadPool(bool (*parse)(const std::string&, T*),
+                                         const std::string& json) {
+  std::pair<bool, T> result;
+  result.first = parse(json, &result.second);
+  return result;
+}
+
+template <typename T>
+void ParseJSON(bool (*parse)(const std::string&, T*),
+               const std::string& json,
+               base::OnceCallback<void(bool, const T&)> callback) {
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&ParseJSONOnThreadPool<T>, parse, json),
+      base::BindOnce(
+          [](base::OnceCallback<void(bool, const T&)> callback,
+             const std::pair<bool, T>& result) {
+            std::move(callback).Run(result.first, result.second);
+          },
+          std::move(callback)));
+}
+
 }  // namespace
 
 namespace ipfs {
@@ -100,9 +127,11 @@ IpfsService::IpfsService(content::BrowserContext* context,
       ipfs_p3a(this, context),
       weak_factory_(this) {
   DCHECK(!user_data_dir.empty());
-  url_loader_factory_ =
+  api_client_ = std::make_unique<IpfsAPIClient>(
       content::BrowserContext::GetDefaultStoragePartition(context)
-          ->GetURLLoaderFactoryForBrowserProcess();
+          ->GetURLLoaderFactoryForBrowserProcess(),
+      base::BindRepeating(&IpfsService::CreateURLLoader,
+                          base::Unretained(this)));
 
   // Return early since g_brave_browser_process and ipfs_client_updater are not
   // available in unit tests.
@@ -252,6 +281,7 @@ void IpfsService::Shutdown() {
 
   ipfs_service_.reset();
   ipfs_pid_ = -1;
+  api_client_->ClearCache();
 }
 
 std::unique_ptr<network::SimpleURLLoader> IpfsService::CreateURLLoader(
@@ -287,13 +317,10 @@ void IpfsService::GetConnectedPeers(GetConnectedPeersCallback callback,
     return;
   }
 
-  auto url_loader = CreateURLLoader(server_endpoint_.Resolve(kSwarmPeersPath));
-  auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
-
-  iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
+  api_client_->Read(
+      server_endpoint_.Resolve(kSwarmPeersPath),
       base::BindOnce(&IpfsService::OnGetConnectedPeers, base::Unretained(this),
-                     std::move(iter), std::move(callback), retries));
+                     std::move(callback), retries));
 }
 
 base::TimeDelta IpfsService::CalculatePeersRetryTime() {
@@ -304,17 +331,11 @@ base::TimeDelta IpfsService::CalculatePeersRetryTime() {
                     kPeersRetryRate * kMinimalPeersRetryIntervalMs));
 }
 
-void IpfsService::OnGetConnectedPeers(
-    SimpleURLLoaderList::iterator iter,
-    GetConnectedPeersCallback callback,
-    int retry_number,
-    std::unique_ptr<std::string> response_body) {
-  auto* url_loader = iter->get();
-  int error_code = url_loader->NetError();
-  int response_code = -1;
-  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
-    response_code = url_loader->ResponseInfo()->headers->response_code();
-  url_loaders_.erase(iter);
+void IpfsService::OnGetConnectedPeers(GetConnectedPeersCallback callback,
+                                      int retry_number,
+                                      int error_code,
+                                      int response_code,
+                                      const std::string& response_body) {
   last_peers_retry_value_for_test_ = retry_number;
   if (error_code == net::ERR_CONNECTION_REFUSED && retry_number) {
     base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
@@ -326,16 +347,24 @@ void IpfsService::OnGetConnectedPeers(
     return;
   }
 
-  std::vector<std::string> peers;
   bool success = (error_code == net::OK && response_code == net::HTTP_OK);
   if (!success) {
     VLOG(1) << "Fail to get connected peers, error_code = " << error_code
             << " response_code = " << response_code;
+    OnConnectedPeersParsed(std::move(callback), false,
+                           std::vector<std::string>());
+    return;
   }
 
-  if (success)
-    success = IPFSJSONParser::GetPeersFromJSON(*response_body, &peers);
+  ParseJSON(&IPFSJSONParser::GetPeersFromJSON, response_body,
+            base::BindOnce(&IpfsService::OnConnectedPeersParsed,
+                           weak_factory_.GetWeakPtr(), std::move(callback)));
+}
 
+void IpfsService::OnConnectedPeersParsed(
+    GetConnectedPeersCallback callback,
+    bool success,
+    const std::vector<std::string>& peers) {
   if (callback)
     std::move(callback).Run(success, peers);
 
@@ -352,37 +381,24 @@ void IpfsService::GetAddressesConfig(GetAddressesConfigCallback callback) {
 
   GURL gurl = net::AppendQueryParameter(server_endpoint_.Resolve(kConfigPath),
                                         kArgQueryParam, kAddressesField);
-  auto url_loader = CreateURLLoader(gurl);
-  auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
-
-  iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
-      base::BindOnce(&IpfsService::OnGetAddressesConfig, base::Unretained(this),
-                     std::move(iter), std::move(callback)));
-}
-
-void IpfsService::OnGetAddressesConfig(
-    SimpleURLLoaderList::iterator iter,
-    GetAddressesConfigCallback callback,
-    std::unique_ptr<std::string> response_body) {
-  auto* url_loader = iter->get();
-  int error_code = url_loader->NetError();
-  int response_code = -1;
-  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
-    response_code = url_loader->ResponseInfo()->headers->response_code();
-  url_loaders_.erase(iter);
-
-  ipfs::AddressesConfig addresses_config;
+  api_client_->Read(
+      gurl, base::BindOnce(&IpfsService::OnGetAddressesConfig,
+                           base::Unretained(this), std::move(callback)));
+}
+
+void IpfsService::OnGetAddressesConfig(GetAddressesConfigCallback callback,
+                                       int error_code,
+                                       int response_code,
+                                       const std::string& response_body) {
   if (error_code != net::OK || response_code != net::HTTP_OK) {
     VLOG(1) << "Fail to get addresses config, error_code = " << error_code
             << " response_code = " << response_code;
-    std::move(callback).Run(false, addresses_config);
+    std::move(callback).Run(false, ipfs::AddressesConfig());
     return;
   }
 
-  bool success = IPFSJSONParser::GetAddressesConfigFromJSON(*response_body,
-                                                            &addresses_config);
-  std::move(callback).Run(success, addresses_config);
+  ParseJSON(&IPFSJSONParser::GetAddressesConfigFromJSON, response_body,
+            std::move(callback));
 }
 
 bool IpfsService::IsDaemonLaunched() const {
@@ -474,6 +490,11 @@ void IpfsService::SetAllowIpfsLaunchForTest(bool launched) {
 
 void IpfsService::SetServerEndpointForTest(const GURL& gurl) {
   server_endpoint_ = gurl;
+  api_client_->ClearCache();
+}
+
+void IpfsService::SetAPICacheTTLForTest(base::TimeDelta ttl) {
+  api_client_->SetCacheTTLForTest(ttl);
 }
 
 void IpfsService::RunLaunchDaemonCallbackForTest(bool result) {
@@ -508,36 +529,24 @@ void IpfsService::GetRepoStats(GetRepoStatsCallback callback) {
       net::AppendQueryParameter(server_endpoint_.Resolve(ipfs::kRepoStatsPath),
                                 ipfs::kRepoStatsHumanReadableParamName,
                                 ipfs::kRepoStatsHumanReadableParamValue);
-  auto url_loader = CreateURLLoader(gurl);
-  auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
-
-  iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
-      base::BindOnce(&IpfsService::OnRepoStats, base::Unretained(this),
-                     std::move(iter), std::move(callback)));
-}
-
-void IpfsService::OnRepoStats(SimpleURLLoaderList::iterator iter,
-                              GetRepoStatsCallback callback,
-                              std::unique_ptr<std::string> response_body) {
-  auto* url_loader = iter->get();
-  int error_code = url_loader->NetError();
-  int response_code = -1;
-  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
-    response_code = url_loader->ResponseInfo()->headers->response_code();
-  url_loaders_.erase(iter);
-
-  ipfs::RepoStats repo_stats;
+  api_client_->Read(gurl, base::BindOnce(&IpfsService::OnRepoStats,
+                                         base::Unretained(this),
+                                         std::move(callback)));
+}
+
+void IpfsService::OnRepoStats(GetRepoStatsCallback callback,
+                              int error_code,
+                              int response_code,
+                              const std::string& response_body) {
   if (error_code != net::OK || response_code != net::HTTP_OK) {
     VLOG(1) << "Fail to get repro stats, error_code = " << error_code
             << " response_code = " << response_code;
-    std::move(callback).Run(false, repo_stats);
+    std::move(callback).Run(false, ipfs::RepoStats());
     return;
   }
 
-  bool success =
-      IPFSJSONParser::GetRepoStatsFromJSON(*response_body, &repo_stats);
-  std::move(callback).Run(success, repo_stats);
+  ParseJSON(&IPFSJSONParser::GetRepoStatsFromJSON, response_body,
+            std::move(callback));
 }
 
 void IpfsService::GetNodeInfo(GetNodeInfoCallback callback) {
@@ -547,36 +556,24 @@ void IpfsService::GetNodeInfo(GetNodeInfoCallback callback) {
   }
 
   GURL gurl = server_endpoint_.Resolve(ipfs::kNodeInfoPath);
-  auto url_loader = CreateURLLoader(gurl);
-  auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
-
-  iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
-      base::BindOnce(&IpfsService::OnNodeInfo, base::Unretained(this),
-                     std::move(iter), std::move(callback)));
-}
-
-void IpfsService::OnNodeInfo(SimpleURLLoaderList::iterator iter,
-                             GetNodeInfoCallback callback,
-                             std::unique_ptr<std::string> response_body) {
-  auto* url_loader = iter->get();
-  int error_code = url_loader->NetError();
-  int response_code = -1;
-  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
-    response_code = url_loader->ResponseInfo()->headers->response_code();
-  url_loaders_.erase(iter);
-
-  ipfs::NodeInfo node_info;
+  api_client_->Read(gurl, base::BindOnce(&IpfsService::OnNodeInfo,
+                                         base::Unretained(this),
+                                         std::move(callback)));
+}
+
+void IpfsService::OnNodeInfo(GetNodeInfoCallback callback,
+                             int error_code,
+                             int response_code,
+                             const std::string& response_body) {
   if (error_code != net::OK || response_code != net::HTTP_OK) {
     VLOG(1) << "Fail to get node info, error_code = " << error_code
             << " response_code = " << response_code;
-    std::move(callback).Run(false, node_info);
+    std::move(callback).Run(false, ipfs::NodeInfo());
     return;
   }
 
-  bool success =
-      IPFSJSONParser::GetNodeInfoFromJSON(*response_body, &node_info);
-  std::move(callback).Run(success, node_info);
+  ParseJSON(&IPFSJSONParser::GetNodeInfoFromJSON, response_body,
+            std::move(callback));
 }
 
 void IpfsService::RunGarbageCollection(GarbageCollectionCallback callback) {
@@ -586,26 +583,15 @@ void IpfsService::RunGarbageCollection(GarbageCollectionCallback callback) {
   }
 
   GURL gurl = server_endpoint_.Resolve(ipfs::kGarbageCollectionPath);
-
-  auto url_loader = CreateURLLoader(gurl);
-  auto iter = url_loaders_.insert(url_loaders_.begin(), std::move(url_loader));
-
-  iter->get()->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
-      url_loader_factory_.get(),
-      base::BindOnce(&IpfsService::OnGarbageCollection, base::Unretained(this),
-                     std::move(iter), std::move(callback)));
+  api_client_->Write(
+      gurl, base::BindOnce(&IpfsService::OnGarbageCollection,
+                           base::Unretained(this), std::move(callback)));
 }
 
-void IpfsService::OnGarbageCollection(
-    SimpleURLLoaderList::iterator iter,
-    GarbageCollectionCallback callback,
-    std::unique_ptr<std::string> response_body) {
-  auto* url_loader = iter->get();
-  int error_code = url_loader->NetError();
-  int response_code = -1;
-  if (url_loader->ResponseInfo() && url_loader->ResponseInfo()->headers)
-    response_code = url_loader->ResponseInfo()->headers->response_code();
-  url_loaders_.erase(iter);
+void IpfsService::OnGarbageCollection(GarbageCollectionCallback callback,
+                                      int error_code,
+                                      int response_code,
+                                      const std::string& response_body) {
 
   bool success = (error_code == net::OK && response_code == net::HTTP_OK);
   if (!success) {
@@ -615,9 +601,8 @@ void IpfsService::OnGarbageCollection(
 
   std::string error;
   if (success) {
-    const std::string& body = *response_body;
-    if (!body.empty())
-      IPFSJSONParser::GetGarbageCollectionFromJSON(body, &error);
+    if (!response_body.empty())
+      IPFSJSONParser::GetGarbageCollectionFromJSON(response_body, &error);
   }
   std::move(callback).Run(success && error.empty(), error);
 }
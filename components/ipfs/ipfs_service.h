@@ -6,7 +6,6 @@
 #ifndef BRAVE_COMPONENTS_IPFS_IPFS_SERVICE_H_
 #define BRAVE_COMPONENTS_IPFS_IPFS_SERVICE_H_
 
-#include <list>
 #include <memory>
 #include <string>
 #include <utility>
@@ -36,7 +35,6 @@ class BrowserContext;
 }  // namespace content
 
 namespace network {
-class SharedURLLoaderFactory;
 class SimpleURLLoader;
 }  // namespace network
 
@@ -45,6 +43,7 @@ class PrefRegistrySimple;
 namespace ipfs {
 
 class BraveIpfsClientUpdater;
+class IpfsAPIClient;
 class IpfsServiceDelegate;
 class IpfsServiceObserver;
 
@@ -106,6 +105,7 @@ class IpfsService : public KeyedService,
 
   void SetAllowIpfsLaunchForTest(bool launched);
   void SetServerEndpointForTest(const GURL& gurl);
+  void SetAPICacheTTLForTest(base::TimeDelta ttl);
   void SetSkipGetConnectedPeersCallbackForTest(bool skip);
   bool WasConnectedPeersCalledForTest() const;
   void SetGetConnectedPeersCalledForTest(bool value);
@@ -117,9 +117,6 @@ class IpfsService : public KeyedService,
   void OnConfigLoaded(GetConfigCallback, const std::pair<bool, std::string>&);
 
  private:
-  using SimpleURLLoaderList =
-      std::list<std::unique_ptr<network::SimpleURLLoader>>;
-
   // BraveIpfsClientUpdater::Observer
   void OnExecutableReady(const base::FilePath& path) override;
   void OnInstallationEvent(ComponentUpdaterEvents event) override;
@@ -134,22 +131,30 @@ class IpfsService : public KeyedService,
   base::TimeDelta CalculatePeersRetryTime();
   std::unique_ptr<network::SimpleURLLoader> CreateURLLoader(const GURL& gurl);
 
-  void OnGetConnectedPeers(SimpleURLLoaderList::iterator iter,
-                           GetConnectedPeersCallback,
+  void OnGetConnectedPeers(GetConnectedPeersCallback,
                            int retries,
-                           std::unique_ptr<std::string> response_body);
-  void OnGetAddressesConfig(SimpleURLLoaderList::iterator iter,
-                            GetAddressesConfigCallback callback,
-                            std::unique_ptr<std::string> response_body);
-  void OnRepoStats(SimpleURLLoaderList::iterator iter,
-                   GetRepoStatsCallback callback,
-                   std::unique_ptr<std::string> response_body);
-  void OnNodeInfo(SimpleURLLoaderList::iterator iter,
-                  GetNodeInfoCallback callback,
-                  std::unique_ptr<std::string> response_body);
-  void OnGarbageCollection(SimpleURLLoaderList::iterator iter,
-                           GarbageCollectionCallback callback,
-                           std::unique_ptr<std::string> response_body);
+                           int error_code,
+                           int response_code,
+                           const std::string& response_body);
+  void OnConnectedPeersParsed(GetConnectedPeersCallback callback,
+                              bool success,
+                              const std::vector<std::string>& peers);
+  void OnGetAddressesConfig(GetAddressesConfigCallback callback,
+                            int error_code,
+                            int response_code,
+                            const std::string& response_body);
+  void OnRepoStats(GetRepoStatsCallback callback,
+                   int error_code,
+                   int response_code,
+                   const std::string& response_body);
+  void OnNodeInfo(GetNodeInfoCallback callback,
+                  int error_code,
+                  int response_code,
+                  const std::string& response_body);
+  void OnGarbageCollection(GarbageCollectionCallback callback,
+                           int error_code,
+                           int response_code,
+                           const std::string& response_body);
 
   std::string GetStorageSize();
   // The remote to the ipfs service running on an utility process. The browser
@@ -161,8 +166,7 @@ class IpfsService : public KeyedService,
   content::BrowserContext* context_;
   base::ObserverList<IpfsServiceObserver> observers_;
 
-  scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
-  SimpleURLLoaderList url_loaders_;
+  std::unique_ptr<IpfsAPIClient> api_client_;
 
   base::queue<LaunchDaemonCallback> pending_launch_callbacks_;
 
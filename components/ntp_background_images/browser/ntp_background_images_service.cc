@@ -9,9 +9,11 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/json/json_reader.h"
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/path_service.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
@@ -39,6 +41,18 @@ namespace ntp_background_images {
 
 namespace {
 
+// Enough for a few sponsored wallpapers and their logos without holding on
+// to every image of a large super referral.
+constexpr size_t kMaxImageFileCacheBytes = 8 * 1024 * 1024;
+
+scoped_refptr<base::RefCountedMemory> ReadImageFile(
+    const base::FilePath& path) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return nullptr;
+  return base::RefCountedString::TakeString(&contents);
+}
+
 constexpr int kSIComponentUpdateCheckIntervalHours = 1;
 constexpr char kNTPManifestFile[] = "photo.json";
 constexpr char kNTPSRMappingTableFile[] = "mapping-table.json";
@@ -100,6 +114,8 @@ NTPBackgroundImagesService::NTPBackgroundImagesService(
     PrefService* local_pref)
     : component_update_service_(cus),
       local_pref_(local_pref),
+      image_file_cache_(ImageFileCache::NO_AUTO_EVICT),
+      max_image_file_cache_bytes_(kMaxImageFileCacheBytes),
       weak_factory_(this) {
 }
 
@@ -443,6 +459,9 @@ void NTPBackgroundImagesService::OnComponentReady(
 void NTPBackgroundImagesService::OnGetComponentJsonData(
     bool is_super_referral,
     const std::string& json_string) {
+  // Images of the previous component version shouldn't be served anymore.
+  ClearImageFileCache();
+
   if (is_super_referral) {
     local_pref_->SetBoolean(
           prefs::kNewTabPageGetInitialSRComponentInProgress,
@@ -522,6 +541,83 @@ NTPBackgroundImagesService::GetTopSitesFaviconList() const {
   return top_site_favicon_list_;
 }
 
+void NTPBackgroundImagesService::GetImageFile(
+    const base::FilePath& image_file_path,
+    GetImageFileCallback callback) {
+  auto cached = image_file_cache_.Get(image_file_path);
+  if (cached != image_file_cache_.end()) {
+    std::move(callback).Run(cached->second);
+    return;
+  }
+
+  auto& pending = pending_image_file_reads_[image_file_path];
+  pending.push_back(std::move(callback));
+  if (pending.size() > 1)
+    return;
+
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::ThreadPool(), base::MayBlock()},
+      base::BindOnce(&ReadImageFile, image_file_path),
+      base::BindOnce(&NTPBackgroundImagesService::OnGotImageFile,
+                     weak_factory_.GetWeakPtr(), image_file_path,
+                     image_file_cache_generation_));
+}
+
+void NTPBackgroundImagesService::PrefetchImageFile(
+    const base::FilePath& image_file_path) {
+  if (image_file_path.empty() ||
+      image_file_cache_.Peek(image_file_path) != image_file_cache_.end()) {
+    return;
+  }
+
+  GetImageFile(image_file_path, base::DoNothing());
+}
+
+void NTPBackgroundImagesService::OnGotImageFile(
+    const base::FilePath& image_file_path,
+    int cache_generation,
+    scoped_refptr<base::RefCountedMemory> data) {
+  if (data && cache_generation == image_file_cache_generation_)
+    CacheImageFile(image_file_path, data);
+
+  auto pending = pending_image_file_reads_.find(image_file_path);
+  if (pending == pending_image_file_reads_.end())
+    return;
+  std::vector<GetImageFileCallback> callbacks = std::move(pending->second);
+  pending_image_file_reads_.erase(pending);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(data);
+}
+
+void NTPBackgroundImagesService::CacheImageFile(
+    const base::FilePath& image_file_path,
+    scoped_refptr<base::RefCountedMemory> data) {
+  if (data->size() > max_image_file_cache_bytes_)
+    return;
+
+  auto existing = image_file_cache_.Peek(image_file_path);
+  if (existing != image_file_cache_.end()) {
+    image_file_cache_bytes_ -= existing->second->size();
+    image_file_cache_.Erase(existing);
+  }
+
+  image_file_cache_bytes_ += data->size();
+  image_file_cache_.Put(image_file_path, std::move(data));
+
+  // Evict the least recently used files until the cache fits its budget.
+  while (image_file_cache_bytes_ > max_image_file_cache_bytes_) {
+    auto oldest = image_file_cache_.rbegin();
+    image_file_cache_bytes_ -= oldest->second->size();
+    image_file_cache_.Erase(oldest);
+  }
+}
+
+void NTPBackgroundImagesService::ClearImageFileCache() {
+  image_file_cache_.Clear();
+  image_file_cache_bytes_ = 0;
+  image_file_cache_generation_++;
+}
+
 void NTPBackgroundImagesService::UnRegisterSuperReferralComponent() {
   if (!component_update_service_)
     return;
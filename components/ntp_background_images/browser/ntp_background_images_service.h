@@ -10,8 +10,12 @@
 #include <string>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/flat_map.h"
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/timer/timer.h"
@@ -41,6 +45,9 @@ class NTPBackgroundImagesService {
     virtual ~Observer() {}
   };
 
+  using GetImageFileCallback =
+      base::OnceCallback<void(scoped_refptr<base::RefCountedMemory> data)>;
+
   static void RegisterLocalStatePrefs(PrefRegistrySimple* registry);
 
   NTPBackgroundImagesService(
@@ -68,6 +75,14 @@ class NTPBackgroundImagesService {
 
   std::vector<std::string> GetTopSitesFaviconList() const;
 
+  // Serves |image_file_path| from the in-memory image cache, reading it on a
+  // background thread on a miss. Concurrent reads of the same file share one
+  // disk read. |callback| gets null data if the file can't be read.
+  void GetImageFile(const base::FilePath& image_file_path,
+                    GetImageFileCallback callback);
+  // Loads |image_file_path| into the image cache ahead of its request.
+  void PrefetchImageFile(const base::FilePath& image_file_path);
+
  private:
   friend class TestNTPBackgroundImagesService;
   friend class NTPBackgroundImagesServiceTest;
@@ -106,6 +121,12 @@ class NTPBackgroundImagesService {
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, BasicTest);
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
                            BasicSuperReferralDataTest);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesServiceTest, ImageFileCacheTest);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesServiceTest,
+                           ImageFileCacheByteLimitTest);
+
+  using ImageFileCache =
+      base::MRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>;
 
   void OnComponentReady(bool is_super_referral,
                         const base::FilePath& installed_dir);
@@ -120,6 +141,12 @@ class NTPBackgroundImagesService {
       const base::Value& component_info) const;
 
   void CacheTopSitesFaviconList();
+  void OnGotImageFile(const base::FilePath& image_file_path,
+                      int cache_generation,
+                      scoped_refptr<base::RefCountedMemory> data);
+  void CacheImageFile(const base::FilePath& image_file_path,
+                      scoped_refptr<base::RefCountedMemory> data);
+  void ClearImageFileCache();
   void CheckSIComponentUpdate(const std::string& component_id);
 
   // virtual for test.
@@ -154,6 +181,17 @@ class NTPBackgroundImagesService {
   // not show SI images until user chooses Brave default images. So, we should
   // know the exact timing whether SR assets is ready to use or not.
   base::Value initial_sr_component_info_;
+  // Image file contents keyed by path. Component files live under versioned
+  // install dirs, so the path also pins the component version. Cleared
+  // whenever component data is updated. Bounded by the total size of the
+  // cached files rather than their count, as wallpapers vary a lot in size.
+  ImageFileCache image_file_cache_;
+  size_t image_file_cache_bytes_ = 0;
+  size_t max_image_file_cache_bytes_;
+  base::flat_map<base::FilePath, std::vector<GetImageFileCallback>>
+      pending_image_file_reads_;
+  // Bumped on clear so reads started before an update aren't cached.
+  int image_file_cache_generation_ = 0;
   base::WeakPtrFactory<NTPBackgroundImagesService> weak_factory_;
 };
 
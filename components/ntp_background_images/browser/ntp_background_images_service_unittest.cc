@@ -6,6 +6,11 @@
 #include <memory>
 #include <string>
 
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/run_loop.h"
 #include "base/test/task_environment.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
@@ -233,6 +238,86 @@ TEST_F(NTPBackgroundImagesServiceTest, InternalDataTest) {
   service_->RemoveObserver(&observer);
 }
 
+TEST_F(NTPBackgroundImagesServiceTest, ImageFileCacheTest) {
+  Init();
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath image_path =
+      temp_dir.GetPath().AppendASCII("background-1.jpg");
+  const std::string contents = "image-bytes";
+  ASSERT_TRUE(base::WriteFile(image_path, contents));
+
+  auto get_image_file = [this](const base::FilePath& path) {
+    scoped_refptr<base::RefCountedMemory> result;
+    base::RunLoop run_loop;
+    service_->GetImageFile(
+        path, base::BindOnce(
+                  [](scoped_refptr<base::RefCountedMemory>* result,
+                     base::OnceClosure quit,
+                     scoped_refptr<base::RefCountedMemory> data) {
+                    *result = std::move(data);
+                    std::move(quit).Run();
+                  },
+                  &result, run_loop.QuitClosure()));
+    run_loop.Run();
+    return result;
+  };
+
+  // Prefetched file is served from memory even after it's gone from disk.
+  service_->PrefetchImageFile(image_path);
+  env_.RunUntilIdle();
+  ASSERT_TRUE(base::DeleteFile(image_path));
+  auto data = get_image_file(image_path);
+  ASSERT_TRUE(data);
+  EXPECT_EQ(contents, std::string(data->front_as<char>(), data->size()));
+
+  // Component update drops cached images.
+  service_->OnGetComponentJsonData(false, kTestEmptyComponent);
+  EXPECT_FALSE(get_image_file(image_path));
+}
+
+TEST_F(NTPBackgroundImagesServiceTest, ImageFileCacheByteLimitTest) {
+  Init();
+  service_->max_image_file_cache_bytes_ = 20;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath image_1 = temp_dir.GetPath().AppendASCII("1.jpg");
+  const base::FilePath image_2 = temp_dir.GetPath().AppendASCII("2.jpg");
+  const base::FilePath image_3 = temp_dir.GetPath().AppendASCII("3.jpg");
+  const base::FilePath large = temp_dir.GetPath().AppendASCII("large.jpg");
+  ASSERT_TRUE(base::WriteFile(image_1, "0123456789"));
+  ASSERT_TRUE(base::WriteFile(image_2, "0123456789"));
+  ASSERT_TRUE(base::WriteFile(image_3, "0123456789"));
+  ASSERT_TRUE(base::WriteFile(large, "0123456789012345678901"));
+
+  service_->PrefetchImageFile(image_1);
+  env_.RunUntilIdle();
+  service_->PrefetchImageFile(image_2);
+  env_.RunUntilIdle();
+  EXPECT_EQ(20u, service_->image_file_cache_bytes_);
+
+  // The least recently used file makes room for a new one.
+  service_->PrefetchImageFile(image_3);
+  env_.RunUntilIdle();
+  EXPECT_EQ(20u, service_->image_file_cache_bytes_);
+  EXPECT_EQ(service_->image_file_cache_.end(),
+            service_->image_file_cache_.Peek(image_1));
+  EXPECT_NE(service_->image_file_cache_.end(),
+            service_->image_file_cache_.Peek(image_2));
+  EXPECT_NE(service_->image_file_cache_.end(),
+            service_->image_file_cache_.Peek(image_3));
+
+  // A file over the whole budget isn't cached and doesn't evict others.
+  service_->PrefetchImageFile(large);
+  env_.RunUntilIdle();
+  EXPECT_EQ(20u, service_->image_file_cache_bytes_);
+  EXPECT_EQ(service_->image_file_cache_.end(),
+            service_->image_file_cache_.Peek(large));
+
+  service_->OnGetComponentJsonData(false, kTestEmptyComponent);
+  EXPECT_EQ(0u, service_->image_file_cache_bytes_);
+}
+
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 
 #if defined(OS_LINUX)
@@ -9,11 +9,13 @@
 #include <string>
 
 #include "base/memory/weak_ptr.h"
-#include "base/optional.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/time/time.h"
 #include "content/public/browser/url_data_source.h"
 
 namespace base {
 class FilePath;
+class RefCountedMemory;
 }  // namespace base
 
 namespace ntp_background_images {
@@ -47,7 +49,8 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   void GetImageFile(const base::FilePath& image_file_path,
                     GotDataCallback callback);
   void OnGotImageFile(GotDataCallback callback,
-                      base::Optional<std::string> input);
+                      base::TimeTicks request_start_time,
+                      scoped_refptr<base::RefCountedMemory> data);
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsDefaultLogoPath(const std::string& path) const;
@@ -217,9 +217,30 @@ void ViewCounterService::RegisterPageView() {
   // or the user opt-in status changing.
   if (IsBrandedWallpaperActive()) {
     model_.RegisterPageView();
+    PrefetchNextBrandedWallpaper();
   }
 }
 
+void ViewCounterService::PrefetchNextBrandedWallpaper() {
+  // Warm the image cache when the next NTP is going to show branded content
+  // so it doesn't wait on disk.
+  if (!model_.ShouldShowBrandedWallpaper())
+    return;
+
+  auto* data = GetCurrentBrandedWallpaperData();
+  if (!data)
+    return;
+
+  const size_t index = model_.current_wallpaper_image_index();
+  if (index >= data->backgrounds.size())
+    return;
+
+  const auto& background = data->backgrounds[index];
+  service_->PrefetchImageFile(background.image_file);
+  service_->PrefetchImageFile(background.logo ? background.logo->image_file
+                                              : data->default_logo.image_file);
+}
+
 void ViewCounterService::BrandedWallpaperLogoClicked(
     const std::string& creative_instance_id,
     const std::string& destination_url,
@@ -119,6 +119,7 @@ class ViewCounterService : public KeyedService,
   bool ShouldShowBrandedWallpaper() const;
 
   void ResetModel();
+  void PrefetchNextBrandedWallpaper();
 
   void UpdateP3AValues() const;
 
@@ -8,8 +8,11 @@
 #include <algorithm>
 #include <utility>
 
+#include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/common/pref_names.h"
 #include "components/omnibox/browser/autocomplete_input.h"
 #include "components/omnibox/browser/autocomplete_provider_client.h"
@@ -39,30 +42,63 @@ void SuggestedSitesProvider::Start(const AutocompleteInput& input,
     return;
   }
 
+  const base::ElapsedTimer timer;
   const std::string input_text =
       base::ToLowerASCII(base::UTF16ToUTF8(input.text()));
-  auto check_add_match =
-      [&](const SuggestedSitesMatch& match) {
+  const auto& suggested_sites = GetSuggestedSites();
+
+  // We'd normally match anywhere in the string but we want only people that
+  // really want these suggestions. Example don't suggest bitcoin and
+  // litecoin for just a coin search. Prefix matches are one contiguous run
+  // of the sorted index.
+  const auto& sorted_index = GetSortedSuggestedSitesIndex();
+  auto it = std::lower_bound(
+      sorted_index.begin(), sorted_index.end(), input_text,
+      [&suggested_sites](size_t index, const std::string& text) {
+        return suggested_sites[index].match_string_ < text;
+      });
+  std::vector<size_t> found;
+  for (; it != sorted_index.end() &&
+         base::StartsWith(suggested_sites[*it].match_string_, input_text);
+       ++it) {
+    found.push_back(*it);
+  }
+  // Keep the order of the suggested sites list.
+  std::sort(found.begin(), found.end());
+
+  for (size_t index : found) {
+    const SuggestedSitesMatch& match = suggested_sites[index];
     // Don't bother matching until 4 chars, or less if it's an exact match
     if (input_text.length() < 4 &&
         match.match_string_.length() != input_text.length()) {
-      return;
-    }
-    size_t foundPos = match.match_string_.find(input_text);
-    // We'd normally check for npos here but we want only people that
-    // really want these suggestions. Example don't suggest bitcoin and
-    // litecoin for just a coin search.
-    if (foundPos == 0) {
-      ACMatchClassifications styles =
-          StylesForSingleMatch(input_text,
-              base::UTF16ToASCII(match.display_));
-      AddMatch(match, styles);
+      continue;
     }
-  };
+    ACMatchClassifications styles =
+        StylesForSingleMatch(input_text, base::UTF16ToASCII(match.display_));
+    AddMatch(match, styles);
+  }
 
-  const auto& suggested_sites = GetSuggestedSites();
-  std::for_each(suggested_sites.begin(), suggested_sites.end(),
-      check_add_match);
+  UMA_HISTOGRAM_CUSTOM_MICROSECONDS_TIMES(
+      "Brave.Omnibox.SuggestedSitesProvider.StartTime", timer.Elapsed(),
+      base::TimeDelta::FromMicroseconds(1), base::TimeDelta::FromSeconds(1),
+      50);
+}
+
+const std::vector<size_t>&
+SuggestedSitesProvider::GetSortedSuggestedSitesIndex() {
+  static const base::NoDestructor<std::vector<size_t>> sorted_index(
+      [](const std::vector<SuggestedSitesMatch>& suggested_sites) {
+        std::vector<size_t> index(suggested_sites.size());
+        for (size_t i = 0; i < index.size(); ++i)
+          index[i] = i;
+        std::stable_sort(index.begin(), index.end(),
+                         [&suggested_sites](size_t a, size_t b) {
+                           return suggested_sites[a].match_string_ <
+                                  suggested_sites[b].match_string_;
+                         });
+        return index;
+      }(GetSuggestedSites()));
+  return *sorted_index;
 }
 
 SuggestedSitesProvider::~SuggestedSitesProvider() {}
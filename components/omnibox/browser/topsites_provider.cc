@@ -6,12 +6,18 @@
 #include "brave/components/omnibox/browser/topsites_provider.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <string>
+#include <utility>
 
+#include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/common/pref_names.h"
 #include "components/omnibox/browser/autocomplete_input.h"
 #include "components/omnibox/browser/history_provider.h"
@@ -21,6 +27,42 @@
 // Search Secondary Provider (suggestion)                              |  100++
 const int TopSitesProvider::kRelevance = 100;
 
+namespace {
+
+// A suffix of |top_sites_[site_index]| starting at |offset|.
+struct SiteSuffix {
+  uint16_t site_index;
+  uint16_t offset;
+};
+
+base::StringPiece SuffixPiece(const std::vector<std::string>& sites,
+                              const SiteSuffix& suffix) {
+  return base::StringPiece(sites[suffix.site_index]).substr(suffix.offset);
+}
+
+// Every suffix of every site, sorted. The sites containing some input are
+// those with a suffix the input is a prefix of, and those suffixes form one
+// contiguous run found by binary search.
+const std::vector<SiteSuffix>& GetSuffixIndex(
+    const std::vector<std::string>& sites) {
+  static const base::NoDestructor<std::vector<SiteSuffix>> index([&sites] {
+    std::vector<SiteSuffix> suffixes;
+    for (size_t i = 0; i < sites.size(); ++i) {
+      for (size_t offset = 0; offset < sites[i].length(); ++offset) {
+        suffixes.push_back(
+            {static_cast<uint16_t>(i), static_cast<uint16_t>(offset)});
+      }
+    }
+    std::sort(suffixes.begin(), suffixes.end(),
+              [&sites](const SiteSuffix& a, const SiteSuffix& b) {
+                return SuffixPiece(sites, a) < SuffixPiece(sites, b);
+              });
+    return suffixes;
+  }());
+  return *index;
+}
+
+}  // namespace
 
 TopSitesProvider::TopSitesProvider(AutocompleteProviderClient* client)
     : AutocompleteProvider(AutocompleteProvider::TYPE_SEARCH), client_(client) {
@@ -39,19 +81,36 @@ void TopSitesProvider::Start(const AutocompleteInput& input,
       (input.type() == metrics::OmniboxInputType::QUERY))
     return;
 
+  const base::ElapsedTimer timer;
   const std::string input_text =
       base::ToLowerASCII(base::UTF16ToUTF8(input.text()));
 
-  for (std::vector<std::string>::const_iterator i = top_sites_.begin();
-       (i != top_sites_.end()) && (matches_.size() < provider_max_matches());
+  // Collect the sites containing |input_text| with each occurrence, sorted
+  // by rank so matches keep the list order.
+  const auto& index = GetSuffixIndex(top_sites_);
+  auto it = std::lower_bound(index.begin(), index.end(), input_text,
+                             [](const SiteSuffix& suffix,
+                                const std::string& text) {
+                               return SuffixPiece(top_sites_, suffix) < text;
+                             });
+  std::vector<std::pair<size_t, size_t>> found_positions;
+  for (; it != index.end() &&
+         base::StartsWith(SuffixPiece(top_sites_, *it), input_text);
+       ++it) {
+    found_positions.emplace_back(it->site_index, it->offset);
+  }
+  std::sort(found_positions.begin(), found_positions.end());
+
+  for (size_t i = 0; i < found_positions.size() &&
+                     matches_.size() < provider_max_matches();
        ++i) {
-    const std::string &current_site = *i;
-    size_t foundPos = current_site.find(input_text);
-    if (std::string::npos != foundPos) {
-      ACMatchClassifications styles =
-          StylesForSingleMatch(input_text, current_site, foundPos);
-      AddMatch(base::ASCIIToUTF16(current_site), styles);
-    }
+    // Only the first occurrence in each site is highlighted.
+    if (i > 0 && found_positions[i].first == found_positions[i - 1].first)
+      continue;
+    const std::string& current_site = top_sites_[found_positions[i].first];
+    ACMatchClassifications styles = StylesForSingleMatch(
+        input_text, current_site, found_positions[i].second);
+    AddMatch(base::ASCIIToUTF16(current_site), styles);
   }
 
   for (size_t i = 0; i < matches_.size(); ++i) {
@@ -66,6 +125,11 @@ void TopSitesProvider::Start(const AutocompleteInput& input,
       matches_[0].relevance = 1250;
     }
   }
+
+  UMA_HISTOGRAM_CUSTOM_MICROSECONDS_TIMES(
+      "Brave.Omnibox.TopSitesProvider.StartTime", timer.Elapsed(),
+      base::TimeDelta::FromMicroseconds(1), base::TimeDelta::FromSeconds(1),
+      50);
 }
 
 TopSitesProvider::~TopSitesProvider() {}
@@ -56,3 +56,16 @@ TEST_F(TopSitesProviderTest, NoMatchingWhenPrefIsOff) {
   provider_->Start(CreateAutocompleteInput("dex"), false);
   EXPECT_TRUE(provider_->matches().empty());
 }
+
+// Matches can start anywhere in the site, keep the list order and highlight
+// the first occurrence.
+TEST_F(TopSitesProviderTest, SubstringMatchesKeepListOrder) {
+  provider_->Start(CreateAutocompleteInput("google"), false);
+  const auto& matches = provider_->matches();
+  ASSERT_GE(matches.size(), 2u);
+  EXPECT_EQ(base::ASCIIToUTF16("google.com"), matches[0].contents);
+  EXPECT_EQ(0u, matches[0].contents_class[0].offset);
+  EXPECT_EQ(base::ASCIIToUTF16("mail.google.com"), matches[1].contents);
+  ASSERT_GE(matches[1].contents_class.size(), 2u);
+  EXPECT_EQ(5u, matches[1].contents_class[1].offset);
+}
@@ -22,6 +22,9 @@ constexpr char kLogValueKey[] = "value";
 constexpr char kLogSentKey[] = "sent";
 constexpr char kLogTimestampKey[] = "timestamp";
 
+// Value updates are written to prefs at most this often.
+constexpr base::TimeDelta kPersistDelay = base::TimeDelta::FromSeconds(10);
+
 void RecordP3A(uint64_t answers_count) {
   int answer = 0;
   if (1 <= answers_count && answers_count < 5) {
@@ -43,7 +46,10 @@ BraveP3ALogStore::BraveP3ALogStore(Delegate* delegate,
   DCHECK(local_state);
 }
 
-BraveP3ALogStore::~BraveP3ALogStore() = default;
+BraveP3ALogStore::~BraveP3ALogStore() {
+  // Don't lose values recorded since the last write.
+  PersistPendingValues();
+}
 
 void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
   registry->RegisterDictionaryPref(kPrefName);
@@ -58,17 +64,36 @@ void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
     unsent_entries_.insert(histogram_name);
   }
 
-  // Update the persistent value.
+  // The persistent value is updated with other pending values later.
+  unpersisted_entries_.insert(histogram_name);
+  if (!persist_timer_.IsRunning()) {
+    persist_timer_.Start(FROM_HERE, kPersistDelay, this,
+                         &BraveP3ALogStore::PersistPendingValues);
+  }
+}
+
+void BraveP3ALogStore::PersistPendingValues() {
+  persist_timer_.Stop();
+  if (unpersisted_entries_.empty())
+    return;
+
   DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  for (const std::string& histogram_name : unpersisted_entries_) {
+    auto iter = log_.find(histogram_name);
+    DCHECK(iter != log_.end());
+    update->SetPath({histogram_name, kLogValueKey},
+                    base::Value(base::NumberToString(iter->second.value)));
+    update->SetPath({histogram_name, kLogSentKey},
+                    base::Value(iter->second.sent));
+  }
+  unpersisted_entries_.clear();
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
   DCHECK(delegate_->IsActualMetric(histogram_name));
   log_.erase(histogram_name);
   unsent_entries_.erase(histogram_name);
+  unpersisted_entries_.erase(histogram_name);
 
   // Update the persistent value.
   DictionaryPrefUpdate update(local_state_, kPrefName);
@@ -81,6 +106,8 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
 }
 
 void BraveP3ALogStore::ResetUploadStamps() {
+  PersistPendingValues();
+
   // Clear log entries flags.
   DictionaryPrefUpdate update(local_state_, kPrefName);
   for (auto& pair : log_) {
@@ -162,6 +189,10 @@ void BraveP3ALogStore::DiscardStagedLog() {
     return;
   }
 
+  // The sent flag below must not be persisted ahead of the value it was
+  // sent for.
+  PersistPendingValues();
+
   // Mark previous staged log as sent.
   auto log_iter = log_.find(staged_entry_key_);
   DCHECK(log_iter != log_.end());
@@ -12,6 +12,7 @@
 #include "base/containers/flat_set.h"
 #include "base/strings/string_piece.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "components/metrics/log_store.h"
 
 class PrefService;
@@ -19,7 +20,8 @@ class PrefRegistrySimple;
 
 namespace brave {
 
-// Stores all given values in memory and persists in prefs on the fly.
+// Stores all given values in memory and persists them in prefs shortly after,
+// batching value updates that arrive close together into one pref write.
 // All logs (not only unsent are persistent), and all logs could be loaded
 // using |LoadPersistedUnsentLogs()|. We should fix this at some point since
 // for now persisted entries never expire.
@@ -48,6 +50,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   void RemoveValueIfExists(const std::string& histogram_name);
   // Marks all saved values as unsent.
   void ResetUploadStamps();
+  // Writes value updates that haven't reached prefs yet.
+  void PersistPendingValues();
 
   // metrics::LogStore:
   bool has_unsent_logs() const override;
@@ -90,6 +94,9 @@ class BraveP3ALogStore : public metrics::LogStore {
   // TODO(iefremov): Try to replace with base::StringPiece?
   base::flat_map<std::string, LogEntry> log_;
   base::flat_set<std::string> unsent_entries_;
+  // Entries whose value changed since the last pref write.
+  base::flat_set<std::string> unpersisted_entries_;
+  base::OneShotTimer persist_timer_;
 
   std::string staged_entry_key_;
   std::string staged_log_;
@@ -0,0 +1,92 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/test/task_environment.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3ALogStoreTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr char kPrefName[] = "p3a.logs";
+constexpr char kTestHistogram[] = "Brave.P3A.TestHistogram";
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) override {
+    return histogram_name.as_string();
+  }
+
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+class BraveP3ALogStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    BraveP3ALogStore::RegisterPrefs(local_state_.registry());
+    log_store_ = std::make_unique<BraveP3ALogStore>(&delegate_, &local_state_);
+
+    registrar_.Init(&local_state_);
+    registrar_.Add(kPrefName,
+                   base::BindRepeating(
+                       &BraveP3ALogStoreTest::OnLogsChanged,
+                       base::Unretained(this)));
+  }
+
+  void OnLogsChanged() { pref_writes_++; }
+
+  const std::string* GetPersistedValue() {
+    // Histogram names contain dots, so they can't be looked up as a path.
+    const base::Value* entry =
+        local_state_.GetDictionary(kPrefName)->FindDictKey(kTestHistogram);
+    return entry ? entry->FindStringKey("value") : nullptr;
+  }
+
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  TestingPrefServiceSimple local_state_;
+  TestDelegate delegate_;
+  std::unique_ptr<BraveP3ALogStore> log_store_;
+  PrefChangeRegistrar registrar_;
+  int pref_writes_ = 0;
+};
+
+TEST_F(BraveP3ALogStoreTest, CoalescesValueUpdates) {
+  log_store_->UpdateValue(kTestHistogram, 1);
+  log_store_->UpdateValue(kTestHistogram, 2);
+  EXPECT_EQ(0, pref_writes_);
+  EXPECT_FALSE(GetPersistedValue());
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(10));
+  EXPECT_EQ(1, pref_writes_);
+  ASSERT_TRUE(GetPersistedValue());
+  EXPECT_EQ("2", *GetPersistedValue());
+}
+
+TEST_F(BraveP3ALogStoreTest, PersistsPendingValuesOnDestruction) {
+  log_store_->UpdateValue(kTestHistogram, 3);
+  EXPECT_FALSE(GetPersistedValue());
+
+  log_store_.reset();
+  ASSERT_TRUE(GetPersistedValue());
+  EXPECT_EQ("3", *GetPersistedValue());
+}
+
+}  // namespace brave
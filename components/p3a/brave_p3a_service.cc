@@ -5,18 +5,22 @@
 
 #include "brave/components/p3a/brave_p3a_service.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/i18n/timezone.h"
+#include "base/metrics/bucket_ranges.h"
+#include "base/metrics/histogram.h"
 #include "base/metrics/histogram_macros.h"
-#include "base/metrics/histogram_samples.h"
 #include "base/metrics/metrics_hashes.h"
-#include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/no_destructor.h"
 #include "base/rand_util.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "base/trace_event/trace_event.h"
@@ -166,11 +170,45 @@ constexpr const char* kCollectedHistograms[] = {
 };
 // clang-format on
 
+// Marks a pending bucket slot that has nothing new for UI thread.
+constexpr int64_t kNoPendingBucket = -1;
+
 bool IsSuspendedMetric(base::StringPiece metric_name,
                        uint64_t value_or_bucket) {
   return value_or_bucket == kSuspendedMetricBucket;
 }
 
+// Maps collected histogram name hashes to their index in
+// |kCollectedHistograms|. Immutable once built, so safe on any thread.
+const base::flat_map<uint64_t, size_t>& GetCollectedHistogramIndex() {
+  static const base::NoDestructor<base::flat_map<uint64_t, size_t>> index([] {
+    std::vector<std::pair<uint64_t, size_t>> entries;
+    for (size_t i = 0; i < base::size(kCollectedHistograms); ++i) {
+      entries.emplace_back(base::HashMetricName(kCollectedHistograms[i]), i);
+    }
+    return base::flat_map<uint64_t, size_t>(std::move(entries));
+  }());
+  return *index;
+}
+
+// Finds the bucket |sample| falls into, as Histogram::Add() would, without
+// snapshotting the histogram.
+size_t GetBucketIndex(const base::BucketRanges* ranges,
+                      base::HistogramBase::Sample sample) {
+  sample = std::max(sample, 0);
+  size_t under = 0;
+  size_t over = ranges->bucket_count();
+  while (over - under > 1) {
+    const size_t mid = under + (over - under) / 2;
+    if (ranges->range(mid) <= sample) {
+      under = mid;
+    } else {
+      over = mid;
+    }
+  }
+  return under;
+}
+
 base::TimeDelta GetRandomizedUploadInterval(
     base::TimeDelta average_upload_interval) {
   const auto delta = base::TimeDelta::FromSecondsD(
@@ -197,7 +235,12 @@ base::TimeDelta TimeDeltaTillMonday(base::Time time) {
 }  // namespace
 
 BraveP3AService::BraveP3AService(PrefService* local_state)
-    : local_state_(local_state) {}
+    : local_state_(local_state),
+      pending_buckets_(
+          new std::atomic<int64_t>[base::size(kCollectedHistograms)]) {
+  for (size_t i = 0; i < base::size(kCollectedHistograms); ++i)
+    pending_buckets_[i].store(kNoPendingBucket, std::memory_order_relaxed);
+}
 
 BraveP3AService::~BraveP3AService() = default;
 
@@ -280,6 +323,13 @@ void BraveP3AService::Init(
   }
 }
 
+void BraveP3AService::OnShutdown() {
+  if (!initialized_)
+    return;
+  OnHistogramsChangedOnUI();
+  log_store_->PersistPendingValues();
+}
+
 std::string BraveP3AService::Serialize(base::StringPiece histogram_name,
                                        uint64_t value) {
   // TRACE_EVENT0("brave_p3a", "SerializeMessage");
@@ -404,63 +454,80 @@ void BraveP3AService::StartScheduledUpload() {
 void BraveP3AService::OnHistogramChanged(const char* histogram_name,
                                          uint64_t name_hash,
                                          base::HistogramBase::Sample sample) {
-  std::unique_ptr<base::HistogramSamples> samples =
-      base::StatisticsRecorder::FindHistogram(histogram_name)->SnapshotDelta();
-  DCHECK(!samples->Iterator()->Done());
+  const auto& collected_index = GetCollectedHistogramIndex();
+  const auto index_iter = collected_index.find(name_hash);
+  if (index_iter == collected_index.end()) {
+    NOTREACHED();
+    return;
+  }
 
+  // Note that we store only buckets, not actual values.
+  int64_t bucket = 0;
   // Shortcut for the special values, see |kSuspendedMetricValue|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
-    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                   base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
-                                  this,
-                                  histogram_name,
-                                  kSuspendedMetricValue,
-                                  kSuspendedMetricBucket));
-    return;
+    bucket = kSuspendedMetricBucket;
+  } else {
+    base::HistogramBase* histogram =
+        base::StatisticsRecorder::FindHistogram(histogram_name);
+    DCHECK(histogram);
+    if (histogram->GetHistogramType() == base::SPARSE_HISTOGRAM) {
+      LOG(ERROR) << "Only linear histograms are supported at the moment!";
+      NOTREACHED();
+      return;
+    }
+    const base::BucketRanges* ranges =
+        static_cast<base::Histogram*>(histogram)->bucket_ranges();
+    bucket = GetBucketIndex(ranges, sample);
+
+    // Special handling of P2A histograms.
+    if (base::StartsWith(histogram_name, "Brave.P2A.",
+                         base::CompareCase::SENSITIVE)) {
+      // We need the bucket count to make proper perturbation.
+      // All P2A metrics should be implemented as linear histograms.
+      const size_t bucket_count = ranges->bucket_count() - 1;
+      VLOG(2) << "P2A metric " << histogram_name << " has bucket count "
+              << bucket_count;
+
+      // Perturb the bucket.
+      bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
+    }
   }
 
-  // Note that we store only buckets, not actual values.
-  size_t bucket = 0u;
-  const bool ok = samples->Iterator()->GetBucketIndex(&bucket);
-  if (!ok) {
-    LOG(ERROR) << "Only linear histograms are supported at the moment!";
-    NOTREACHED();
-    return;
-  }
+  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
+          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
 
-  // Special handling of P2A histograms.
-  if (base::StartsWith(histogram_name, "Brave.P2A.",
-                       base::CompareCase::SENSITIVE)) {
-    // We need the bucket count to make proper perturbation.
-    // All P2A metrics should be implemented as linear histograms.
-    base::SampleVector* vector =
-        static_cast<base::SampleVector*>(samples.get());
-    DCHECK(vector);
-    const size_t bucket_count = vector->bucket_ranges()->bucket_count() - 1;
-    VLOG(2) << "P2A metric " << histogram_name << " has bucket count "
-            << bucket_count;
-
-    // Perturb the bucket.
-    bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
+  // Only the latest bucket matters, so a value that UI thread hasn't picked
+  // up yet is simply replaced.
+  if (pending_buckets_[index_iter->second].exchange(bucket) !=
+      kNoPendingBucket) {
+    coalesced_update_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!drain_posted_.exchange(true)) {
+    base::PostTask(
+        FROM_HERE, {content::BrowserThread::UI},
+        base::BindOnce(&BraveP3AService::OnHistogramsChangedOnUI, this));
   }
-
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
 }
 
-void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
-  VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
-          << histogram_name << " Sample = " << sample << " bucket = " << bucket;
-  if (!initialized_) {
-    // Will handle it later when ready.
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    HandleHistogramChange(histogram_name, bucket);
+void BraveP3AService::OnHistogramsChangedOnUI() {
+  // Clear the flag before draining so that samples recorded while draining
+  // post a new task.
+  drain_posted_.store(false);
+  for (size_t i = 0; i < base::size(kCollectedHistograms); ++i) {
+    const int64_t bucket = pending_buckets_[i].exchange(kNoPendingBucket);
+    if (bucket == kNoPendingBucket)
+      continue;
+    const char* histogram_name = kCollectedHistograms[i];
+    if (!initialized_) {
+      // Will handle it later when ready.
+      histogram_values_[histogram_name] = bucket;
+    } else {
+      HandleHistogramChange(histogram_name, bucket);
+    }
   }
+  VLOG(2) << "BraveP3AService coalesced updates so far: "
+          << coalesced_update_count();
 }
 
 void BraveP3AService::HandleHistogramChange(base::StringPiece histogram_name,
@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 #define BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -47,6 +48,10 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void Init(
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
 
+  // Writes pending histogram values to local state. Should be called before
+  // local state is committed to disk at shutdown.
+  void OnShutdown();
+
   // BraveP3ALogStore::Delegate
   std::string Serialize(base::StringPiece histogram_name,
                         uint64_t value) override;
@@ -54,6 +59,12 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // May be accessed from multiple threads, so this is thread-safe.
   bool IsActualMetric(base::StringPiece histogram_name) const override;
 
+  // Number of histogram updates that were overwritten by a newer value of the
+  // same histogram before reaching the log store.
+  uint64_t coalesced_update_count() const {
+    return coalesced_update_count_.load(std::memory_order_relaxed);
+  }
+
  private:
   friend class base::RefCountedThreadSafe<BraveP3AService>;
   ~BraveP3AService() override;
@@ -68,14 +79,14 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void StartScheduledUpload();
 
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
+  // can fire on any thread, this method only records the latest bucket of the
+  // histogram and makes sure a drain task is pending on UI thread.
   void OnHistogramChanged(const char* histogram_name,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(const char* histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  // Hands the latest bucket of every changed histogram over to the log store.
+  void OnHistogramsChangedOnUI();
 
   // Updates or removes a metric from the log.
   void HandleHistogramChange(base::StringPiece histogram_name, size_t bucket);
@@ -109,6 +120,14 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // the service and its initialization.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
 
+  // Latest bucket per collected histogram, indexed like the collected
+  // histograms list and written lock-free from any thread. Slots without a
+  // value waiting for UI thread hold a sentinel.
+  std::unique_ptr<std::atomic<int64_t>[]> pending_buckets_;
+  // Set while a drain task is posted, so a burst of samples posts once.
+  std::atomic<bool> drain_posted_{false};
+  std::atomic<uint64_t> coalesced_update_count_{0};
+
   // Once fired we restart the overall uploading process.
   base::OneShotTimer rotation_timer_;
 
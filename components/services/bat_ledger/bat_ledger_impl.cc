@@ -983,6 +983,31 @@ void BatLedgerImpl::GetAllContributions(GetAllContributionsCallback callback) {
       _1));
 }
 
+// static
+void BatLedgerImpl::OnGetContributionsPage(
+    CallbackHolder<GetContributionsPageCallback>* holder,
+    ledger::type::ContributionInfoList list,
+    const std::string& next_page_token) {
+  DCHECK(holder);
+  if (holder->is_valid())
+    std::move(holder->get()).Run(std::move(list), next_page_token);
+
+  delete holder;
+}
+
+void BatLedgerImpl::GetContributionsPage(
+    const std::string& page_token,
+    const uint32_t limit,
+    GetContributionsPageCallback callback) {
+  auto* holder = new CallbackHolder<GetContributionsPageCallback>(
+      AsWeakPtr(), std::move(callback));
+
+  ledger_->GetContributionsPage(
+      page_token,
+      limit,
+      std::bind(BatLedgerImpl::OnGetContributionsPage, holder, _1, _2));
+}
+
 // static
 void BatLedgerImpl::OnSavePublisherInfoForTip(
     CallbackHolder<SavePublisherInfoForTipCallback>* holder,
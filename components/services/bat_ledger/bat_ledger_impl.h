@@ -226,6 +226,11 @@ class BatLedgerImpl :
 
   void GetAllContributions(GetAllContributionsCallback callback) override;
 
+  void GetContributionsPage(
+      const std::string& page_token,
+      const uint32_t limit,
+      GetContributionsPageCallback callback) override;
+
   void SavePublisherInfoForTip(
       ledger::type::PublisherInfoPtr info,
       SavePublisherInfoForTipCallback callback) override;
@@ -419,6 +424,11 @@ class BatLedgerImpl :
       CallbackHolder<GetAllContributionsCallback>* holder,
       ledger::type::ContributionInfoList list);
 
+  static void OnGetContributionsPage(
+      CallbackHolder<GetContributionsPageCallback>* holder,
+      ledger::type::ContributionInfoList list,
+      const std::string& next_page_token);
+
   static void OnSavePublisherInfoForTip(
       CallbackHolder<SavePublisherInfoForTipCallback>* holder,
       const ledger::type::Result result);
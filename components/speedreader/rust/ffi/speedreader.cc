@@ -124,4 +124,10 @@ const std::string& Rewriter::GetOutput() {
   return output_;
 }
 
+std::string Rewriter::TakeOutput() {
+  std::string output;
+  output.swap(output_);
+  return output;
+}
+
 }  // namespace speedreader
@@ -69,6 +69,11 @@ class SPEEDREADER_EXPORT Rewriter {
   /// callback was provided, otherwise will return an empty string.
   const std::string& GetOutput();
 
+  /// Returns output accumulated since the previous call and clears it, so the
+  /// caller can forward output while more input is still being `Written`.
+  /// Like `GetOutput`, only useful if no explicit callback was provided.
+  std::string TakeOutput();
+
  private:
   std::string output_;
   bool ended_;
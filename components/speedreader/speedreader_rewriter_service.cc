@@ -105,6 +105,10 @@ std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
   return speedreader_->MakeRewriter(url.spec(), backend_);
 }
 
+bool SpeedreaderRewriterService::RewriterStreamsOutput() const {
+  return backend_ == RewriterType::RewriterStreaming;
+}
+
 const std::string& SpeedreaderRewriterService::GetContentStylesheet() {
   return content_stylesheet_;
 }
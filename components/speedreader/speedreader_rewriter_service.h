@@ -45,6 +45,9 @@ class SpeedreaderRewriterService : public SpeedreaderComponent::Observer {
   // The API
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // Whether rewriters produce output as the body is written to them. The
+  // heuristics backend buffers the page and only produces output at End().
+  bool RewriterStreamsOutput() const;
   const std::string& GetContentStylesheet();
 
  private:
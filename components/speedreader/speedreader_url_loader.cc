@@ -10,8 +10,11 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/compiler_specific.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
+#include "base/task_runner_util.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
@@ -24,6 +27,20 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledOutputSize = 1024;
+
+// The original body is kept for falling back only up to this size. If a
+// streaming rewriter has not produced a distilled page by then, the page is
+// sent as is. Buffering rewriters only produce output at the end of the body,
+// so they are not capped.
+constexpr size_t kMaxUndecidedBodySize = 2 * 1024 * 1024;
+
+// Reading from the source is paused while this much output is waiting to be
+// written to the destination.
+constexpr size_t kMaxPendingOutputSize = 1024 * 1024;
+
 }  // namespace
 
 // static
@@ -62,6 +79,9 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       destination_url_loader_client_(std::move(destination_url_loader_client)),
       response_url_(response_url),
       task_runner_(task_runner),
+      distill_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::TaskPriority::USER_BLOCKING})),
+      rewriter_(nullptr, base::OnTaskRunnerDeleter(distill_task_runner_)),
       body_consumer_watcher_(FROM_HERE,
                              mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                              task_runner),
@@ -118,6 +138,14 @@ void SpeedReaderURLLoader::OnStartLoadingResponseBody(
     mojo::ScopedDataPipeConsumerHandle body) {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kLoading;
+  if (!rewriter_service_) {
+    Abort();
+    return;
+  }
+  rewriter_.reset(rewriter_service_->MakeRewriter(response_url_).release());
+  rewriter_streams_output_ = rewriter_service_->RewriterStreamsOutput();
+  stylesheet_ = rewriter_service_->GetContentStylesheet();
+
   body_consumer_handle_ = std::move(body);
   body_consumer_watcher_.Watch(
       body_consumer_handle_.get(),
@@ -187,21 +215,43 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
   source_url_loader_->ResumeReadingBodyFromNet();
 }
 
+// static
+SpeedReaderURLLoader::DistillResult SpeedReaderURLLoader::WriteChunk(
+    Rewriter* rewriter,
+    std::string chunk) {
+  base::ElapsedTimer timer;
+  DistillResult result;
+  result.success = rewriter->Write(chunk.data(), chunk.length()) == 0;
+  result.output = rewriter->TakeOutput();
+  result.elapsed = timer.Elapsed();
+  return result;
+}
+
+// static
+SpeedReaderURLLoader::DistillResult SpeedReaderURLLoader::EndRewriter(
+    Rewriter* rewriter) {
+  base::ElapsedTimer timer;
+  DistillResult result;
+  result.success = rewriter->End() == 0;
+  result.output = rewriter->TakeOutput();
+  result.elapsed = timer.Elapsed();
+  return result;
+}
+
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
-  DCHECK_EQ(State::kLoading, state_);
+  DCHECK(state_ == State::kLoading || state_ == State::kSending);
+  DCHECK(!distill_in_flight_);
 
-  size_t start_size = buffered_body_.size();
+  std::string chunk(kReadBufferSize, '\0');
   uint32_t read_bytes = kReadBufferSize;
-  buffered_body_.resize(start_size + read_bytes);
   MojoResult result = body_consumer_handle_->ReadData(
-      &buffered_body_[0] + start_size, &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+      &chunk[0], &read_bytes, MOJO_READ_DATA_FLAG_NONE);
   switch (result) {
     case MOJO_RESULT_OK:
       break;
     case MOJO_RESULT_FAILED_PRECONDITION:
       // Reading is finished.
-      buffered_body_.resize(start_size);
-      MaybeLaunchSpeedreader();
+      OnBodyReadFinished();
       return;
     case MOJO_RESULT_SHOULD_WAIT:
       body_consumer_watcher_.ArmOrNotify();
@@ -212,71 +262,168 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   }
 
   DCHECK_EQ(MOJO_RESULT_OK, result);
-  buffered_body_.resize(start_size + read_bytes);
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  chunk.resize(read_bytes);
 
-  body_consumer_watcher_.ArmOrNotify();
+  if (mode_ == Mode::kPassthrough) {
+    AppendOutput(chunk);
+    ReadMoreOrPause();
+    return;
+  }
+
+  if (mode_ == Mode::kUndecided) {
+    buffered_body_.append(chunk);
+    if (rewriter_streams_output_ &&
+        buffered_body_.size() > kMaxUndecidedBodySize) {
+      FallBackToOriginal();
+      ReadMoreOrPause();
+      return;
+    }
+  }
+
+  // Pumping is not free in terms of CPU ticks, so the rewriter lives on
+  // another sequence. Only one chunk is in flight at a time, which keeps the
+  // output in order and lets the data pipe apply backpressure.
+  distill_in_flight_ = true;
+  base::PostTaskAndReplyWithResult(
+      distill_task_runner_.get(), FROM_HERE,
+      base::BindOnce(&SpeedReaderURLLoader::WriteChunk,
+                     base::Unretained(rewriter_.get()), std::move(chunk)),
+      base::BindOnce(&SpeedReaderURLLoader::OnChunkDistilled,
+                     weak_factory_.GetWeakPtr()));
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
   DCHECK_EQ(State::kSending, state_);
-  if (bytes_remaining_in_buffer_ > 0) {
-    SendReceivedBodyToClient();
+  SendReceivedBodyToClient();
+}
+
+void SpeedReaderURLLoader::OnBodyReadFinished() {
+  body_read_finished_ = true;
+  switch (mode_) {
+    case Mode::kPassthrough:
+      // Completes sending if all output has already been written.
+      AppendOutput(base::StringPiece());
+      return;
+    case Mode::kUndecided:
+      if (buffered_body_.empty()) {
+        FallBackToOriginal();
+        return;
+      }
+      FALLTHROUGH;
+    case Mode::kDistilling:
+      distill_in_flight_ = true;
+      base::PostTaskAndReplyWithResult(
+          distill_task_runner_.get(), FROM_HERE,
+          base::BindOnce(&SpeedReaderURLLoader::EndRewriter,
+                         base::Unretained(rewriter_.get())),
+          base::BindOnce(&SpeedReaderURLLoader::OnDistillEnded,
+                         weak_factory_.GetWeakPtr()));
+      return;
+  }
+  NOTREACHED();
+}
+
+void SpeedReaderURLLoader::OnChunkDistilled(DistillResult result) {
+  if (state_ == State::kAborted)
+    return;
+  DCHECK(distill_in_flight_);
+  distill_in_flight_ = false;
+  distill_time_ += result.elapsed;
+
+  if (mode_ == Mode::kUndecided) {
+    if (!result.success) {
+      FallBackToOriginal();
+    } else {
+      distilled_prefix_.append(result.output);
+      if (distilled_prefix_.size() >= kMinDistilledOutputSize)
+        CommitToDistilled();
+    }
   } else {
-    CompleteSending();
+    DCHECK_EQ(Mode::kDistilling, mode_);
+    if (!result.success) {
+      // Distilled output has already been sent, so there is nothing left to
+      // fall back to. Finish the page with what has been distilled so far.
+      VLOG(2) << __func__ << " rewriter failed after commit";
+      body_read_finished_ = true;
+      ResetRewriter();
+    }
+    AppendOutput(result.output);
   }
+  ReadMoreOrPause();
 }
 
-void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
-  DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !rewriter_service_) {
-    Abort();
+void SpeedReaderURLLoader::OnDistillEnded(DistillResult result) {
+  if (state_ == State::kAborted)
+    return;
+  DCHECK(distill_in_flight_);
+  distill_in_flight_ = false;
+  distill_time_ += result.elapsed;
+
+  ResetRewriter();
+
+  if (mode_ == Mode::kUndecided) {
+    distilled_prefix_.append(result.output);
+    if (result.success && distilled_prefix_.size() >= kMinDistilledOutputSize)
+      CommitToDistilled();
+    else
+      FallBackToOriginal();
     return;
   }
 
-  VLOG(2) << __func__ << " buffered body size = " << buffered_body_.size();
-  bytes_remaining_in_buffer_ = buffered_body_.size();
-
-  if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_BLOCKING},
-        base::BindOnce(
-            [](std::string data, std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto {
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-
-              return stylesheet + transformed;
-            },
-            std::move(buffered_body_),
-            rewriter_service_->MakeRewriter(response_url_),
-            rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(&SpeedReaderURLLoader::CompleteLoading,
-                       weak_factory_.GetWeakPtr()));
+  DCHECK_EQ(Mode::kDistilling, mode_);
+  // Completes sending once all output has been written.
+  AppendOutput(result.output);
+}
+
+void SpeedReaderURLLoader::ReadMoreOrPause() {
+  if (state_ == State::kAborted || state_ == State::kCompleted ||
+      body_read_finished_) {
+    return;
+  }
+  if (output_buffer_.size() - output_buffer_offset_ > kMaxPendingOutputSize) {
+    // Resumed by SendReceivedBodyToClient() once the output is drained.
+    body_reading_paused_ = true;
     return;
   }
-  CompleteLoading(std::move(buffered_body_));
+  body_consumer_watcher_.ArmOrNotify();
 }
 
-void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+void SpeedReaderURLLoader::ResetRewriter() {
+  if (!rewriter_)
+    return;
+  if (!distill_time_.is_zero())
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", distill_time_);
+  rewriter_.reset();
+}
+
+void SpeedReaderURLLoader::CommitToDistilled() {
+  DCHECK_EQ(Mode::kUndecided, mode_);
+  VLOG(2) << __func__ << " undecided body size = " << buffered_body_.size();
+  mode_ = Mode::kDistilling;
+  std::string().swap(buffered_body_);
+
+  CompleteLoading();
+  AppendOutput(stylesheet_);
+  AppendOutput(distilled_prefix_);
+  std::string().swap(stylesheet_);
+  std::string().swap(distilled_prefix_);
+}
+
+void SpeedReaderURLLoader::FallBackToOriginal() {
+  DCHECK_EQ(Mode::kUndecided, mode_);
+  VLOG(2) << __func__ << " undecided body size = " << buffered_body_.size();
+  mode_ = Mode::kPassthrough;
+  ResetRewriter();
+  std::string().swap(stylesheet_);
+  std::string().swap(distilled_prefix_);
+
+  CompleteLoading();
+  std::string body;
+  body.swap(buffered_body_);
+  AppendOutput(body);
+}
+
+void SpeedReaderURLLoader::CompleteLoading() {
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
 
@@ -285,9 +432,6 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
     return;
   }
 
-  buffered_body_ = std::move(body);
-  bytes_remaining_in_buffer_ = buffered_body_.size();
-
   throttle_->Resume();
   mojo::ScopedDataPipeConsumerHandle body_to_send;
   MojoResult result =
@@ -306,14 +450,17 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   // Send deferred message.
   destination_url_loader_client_->OnStartLoadingResponseBody(
       std::move(body_to_send));
+}
 
-  DCHECK(bytes_remaining_in_buffer_);
-  if (bytes_remaining_in_buffer_) {
-    SendReceivedBodyToClient();
+void SpeedReaderURLLoader::AppendOutput(base::StringPiece data) {
+  if (state_ != State::kSending)
     return;
-  }
-
-  CompleteSending();
+  // If there is unsent output, a write is already pending on
+  // |body_producer_watcher_| and will pick up the new data.
+  const bool idle = output_buffer_offset_ == output_buffer_.size();
+  data.AppendToString(&output_buffer_);
+  if (idle)
+    SendReceivedBodyToClient();
 }
 
 void SpeedReaderURLLoader::CompleteSending() {
@@ -332,13 +479,25 @@ void SpeedReaderURLLoader::CompleteSending() {
 
 void SpeedReaderURLLoader::SendReceivedBodyToClient() {
   DCHECK_EQ(State::kSending, state_);
-  // Send the buffered data first.
-  DCHECK_GT(bytes_remaining_in_buffer_, 0u);
-  size_t start_position = buffered_body_.size() - bytes_remaining_in_buffer_;
-  uint32_t bytes_sent = bytes_remaining_in_buffer_;
-  MojoResult result =
-      body_producer_handle_->WriteData(buffered_body_.data() + start_position,
-                                       &bytes_sent, MOJO_WRITE_DATA_FLAG_NONE);
+  if (output_buffer_offset_ == output_buffer_.size()) {
+    output_buffer_.clear();
+    output_buffer_offset_ = 0;
+    if (body_read_finished_ && !distill_in_flight_) {
+      CompleteSending();
+      return;
+    }
+    if (body_reading_paused_) {
+      body_reading_paused_ = false;
+      ReadMoreOrPause();
+    }
+    return;
+  }
+
+  uint32_t bytes_sent =
+      static_cast<uint32_t>(output_buffer_.size() - output_buffer_offset_);
+  MojoResult result = body_producer_handle_->WriteData(
+      output_buffer_.data() + output_buffer_offset_, &bytes_sent,
+      MOJO_WRITE_DATA_FLAG_NONE);
   switch (result) {
     case MOJO_RESULT_OK:
       break;
@@ -354,7 +513,14 @@ void SpeedReaderURLLoader::SendReceivedBodyToClient() {
       NOTREACHED();
       return;
   }
-  bytes_remaining_in_buffer_ -= bytes_sent;
+  output_buffer_offset_ += bytes_sent;
+  // Drop the sent part once it dominates the buffer, so that a destination
+  // that never fully catches up does not make the buffer grow unbounded.
+  if (output_buffer_offset_ > kReadBufferSize &&
+      output_buffer_offset_ * 2 > output_buffer_.size()) {
+    output_buffer_.erase(0, output_buffer_offset_);
+    output_buffer_offset_ = 0;
+  }
   body_producer_watcher_.ArmOrNotify();
 }
 
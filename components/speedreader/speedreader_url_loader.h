@@ -6,12 +6,15 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/time/time.h"
 #include "base/memory/weak_ptr.h"
 #include "base/strings/string_piece.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
@@ -25,26 +28,35 @@
 
 namespace speedreader {
 
+class Rewriter;
 class SpeedReaderThrottle;
 class SpeedreaderRewriterService;
 
-// Loads the whole response body and tries to Speedreader-distill it.
+// Streams the response body through a Speedreader rewriter.
 // Cargoculted from |`SniffingURLLoader|.
 //
+// Body chunks are fed to the rewriter on a sequenced thread pool runner as
+// they arrive. The original bytes are kept only until the rewriter has
+// produced enough output to be considered a successful distillation; after
+// that the distilled output is forwarded to the destination incrementally.
+// If the rewriter fails, or does not succeed within a bounded prefix of the
+// body, the kept original bytes are sent and the rest of the body is passed
+// through untouched.
+//
 // This loader has five states:
 // kWaitForBody: The initial state until the body is received (=
 //               OnStartLoadingResponseBody() is called) or the response is
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
-//            done, this loader will dispatch queued messages like
-//            OnStartLoadingResponseBody() to the destination
-//            loader client, and then the state is changed to kSending.
-// kSending: Receives the body and sends it to the destination loader client.
-//           The state changes to kCompleted after all data is sent.
+// kLoading: Receives the body from the source loader and distills the page
+//           until it is decided whether the distilled or the original body
+//           is sent. Then this loader will dispatch queued messages like
+//           OnStartLoadingResponseBody() to the destination loader client,
+//           and the state is changed to kSending.
+// kSending: Keeps receiving (and possibly distilling) the body and sends the
+//           output to the destination loader client. The state changes to
+//           kCompleted after all data is received and sent.
 // kCompleted: All data has been sent to the destination loader.
 // kAborted: Unexpected behavior happens. Watchers, pipes and the binding from
 //           the source loader to |this| are stopped. All incoming messages from
@@ -109,12 +121,38 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   void PauseReadingBodyFromNet() override;
   void ResumeReadingBodyFromNet() override;
 
+  struct DistillResult {
+    bool success = false;
+    std::string output;
+    base::TimeDelta elapsed;
+  };
+
+  enum class Mode {
+    // Distilling, but the original body is kept in case distilling fails.
+    kUndecided,
+    // Sending the distilled output.
+    kDistilling,
+    // Sending the original body.
+    kPassthrough,
+  };
+
+  static DistillResult WriteChunk(Rewriter* rewriter, std::string chunk);
+  static DistillResult EndRewriter(Rewriter* rewriter);
+
   void OnBodyReadable(MojoResult);
   void OnBodyWritable(MojoResult);
-  void MaybeLaunchSpeedreader();
-
-  // Gets either distilled or untouched body.
-  void CompleteLoading(std::string body);
+  void OnBodyReadFinished();
+  void OnChunkDistilled(DistillResult result);
+  void OnDistillEnded(DistillResult result);
+  void ReadMoreOrPause();
+  void ResetRewriter();
+
+  // Switches to sending either the distilled or the untouched body.
+  void CommitToDistilled();
+  void FallBackToOriginal();
+  void CompleteLoading();
+
+  void AppendOutput(base::StringPiece data);
   void CompleteSending();
   void SendReceivedBodyToClient();
 
@@ -137,9 +175,28 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   // Set if OnComplete() is called during distilling.
   base::Optional<network::URLLoaderCompletionStatus> complete_status_;
 
-  // Note that this could be replaced by a distilled version.
+  Mode mode_ = Mode::kUndecided;
+
+  // Runs |rewriter_|, which is deleted on that sequence as well.
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  std::unique_ptr<Rewriter, base::OnTaskRunnerDeleter> rewriter_;
+  bool distill_in_flight_ = false;
+  // False for rewriters that only produce output at the end of the body.
+  bool rewriter_streams_output_ = true;
+  base::TimeDelta distill_time_;
+  std::string stylesheet_;
+
+  // The original body received while in Mode::kUndecided, and the rewriter
+  // output produced for it.
   std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+  std::string distilled_prefix_;
+
+  // Output not yet written to |body_producer_handle_|.
+  std::string output_buffer_;
+  size_t output_buffer_offset_ = 0;
+
+  bool body_read_finished_ = false;
+  bool body_reading_paused_ = false;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;
@@ -5,6 +5,8 @@
 
 #include "brave/components/tor/tor_control.h"
 
+#include <string.h>
+
 #include "base/sequenced_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -698,38 +700,43 @@ void TorControl::ReadDone(int rv) {
     return;
   }
   const char* data = readiobuf_->data();
-  for (int i = 0; i < rv; i++) {
+  const char* const data_end = data + rv;
+  const char* p = data;
+  while (p < data_end) {
     if (!read_cr_) {
-      // No CR yet.  Accept CR or non-LF; reject LF.
-      if (data[i] == 0x0d) {  // CR
-        read_cr_ = true;
-      } else if (data[i] == 0x0a) {  // LF
+      // No CR yet.  Skip ahead to the next CR, rejecting any LF on
+      // the way.
+      const char* cr = static_cast<const char*>(memchr(p, 0x0d, data_end - p));
+      const char* scan_end = cr ? cr : data_end;
+      if (memchr(p, 0x0a, scan_end - p)) {
         VLOG(1) << "tor: stray line feed";
         Error();
         return;
-      } else {
-        // Anything else: Just accept it and move on.
       }
+      if (!cr)
+        break;
+      read_cr_ = true;
+      p = cr + 1;
     } else {
       // CR seen.  Accept LF; reject all else.
-      if (data[i] == 0x0a) {  // LF
-        // CRLF seen, so we must have i >= 2.  Emit a line and advance
-        // to the next one, unless anything went wrong with the line.
-        assert(i >= 1);
-        std::string line(readiobuf_->StartOfBuffer() + read_start_,
-                         readiobuf_->offset() + i - 1 - read_start_);
-        read_start_ = readiobuf_->offset() + i + 1;
-        read_cr_ = false;
-        if (!ReadLine(line)) {
-          reading_ = false;
-          return;
-        }
-      } else {
-        // CR seen, but not LF.  Bad.
+      if (*p != 0x0a) {
         VLOG(1) << "tor: stray carriage return";
         Error();
         return;
       }
+      // CRLF seen.  Emit the line in place and advance to the next
+      // one, unless anything went wrong with the line.
+      const int lf = readiobuf_->offset() + static_cast<int>(p - data);
+      DCHECK_GE(lf, read_start_ + 1);
+      base::StringPiece line(readiobuf_->StartOfBuffer() + read_start_,
+                             lf - 1 - read_start_);
+      read_start_ = lf + 1;
+      read_cr_ = false;
+      if (!ReadLine(line)) {
+        reading_ = false;
+        return;
+      }
+      p++;
     }
   }
 
@@ -773,7 +780,7 @@ void TorControl::ReadDone(int rv) {
 //      We have read a line of input; process it.  Return true on
 //      success, false on error.
 //
-bool TorControl::ReadLine(const std::string& line) {
+bool TorControl::ReadLine(base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
 
   if (line.size() < 4) {
@@ -788,21 +795,21 @@ bool TorControl::ReadLine(const std::string& line) {
   // intermediate reply and ` ' for a final reply.
   //
   // TODO(riastradh): parse or check syntax of status
-  std::string status(line, 0, 3);
-  char pos = line[3];
-  std::string reply(line, 4);
+  const base::StringPiece status = line.substr(0, 3);
+  const char pos = line[3];
+  const base::StringPiece reply = line.substr(4);
 
   // Determine whether it is an asynchronous reply, status 6yz.
   if (status[0] == '6') {
     // Notify delegate of the raw reply.
-    NotifyTorRawAsync(status, reply);
+    NotifyTorRawAsync(status.as_string(), reply.as_string());
 
     // Is this a new async reply?
     if (!async_) {
       // Parse the keyword and the initial line.
       const size_t sp = reply.find(' ');
-      std::string event_name, initial;
-      if (sp == std::string::npos) {
+      base::StringPiece event_name, initial;
+      if (sp == base::StringPiece::npos) {
         event_name = reply;
       } else {
         event_name = reply.substr(0, sp);
@@ -830,7 +837,7 @@ bool TorControl::ReadLine(const std::string& line) {
 
           // Notify the delegate of the parsed reply.  No extra
           // because there were no intermediate reply lines.
-          NotifyTorEvent(event, initial, {});
+          NotifyTorEvent(event, initial.as_string(), {});
 
           return true;
         }
@@ -845,7 +852,7 @@ bool TorControl::ReadLine(const std::string& line) {
                                                      : (*found).second);
           async_ = std::make_unique<Async>();
           async_->event = event;
-          async_->initial = initial;
+          async_->initial = initial.as_string();
           async_->skip = (event == TorControlEvent::INVALID);
           return true;
         }
@@ -873,12 +880,12 @@ bool TorControl::ReadLine(const std::string& line) {
             Error();
             return false;
           }
-          if (async_->extra.count(key)) {
+          if (!async_->extra.emplace(std::move(key), std::move(value))
+                   .second) {
             VLOG(1) << "tor: duplicate key in async continuation line";
             Error();
             return false;
           }
-          async_->extra[key] = value;
           return true;
         }
         case ' ': {
@@ -891,17 +898,19 @@ bool TorControl::ReadLine(const std::string& line) {
               Error();
               return false;
             }
-            if (async_->extra.count(key)) {
+            if (!async_->extra.emplace(std::move(key), std::move(value))
+                     .second) {
               VLOG(1) << "tor: duplicate key in async event";
               Error();
               return false;
             }
-            async_->extra[key] = value;
 
             // If we're still subscribed, notify the delegate of the
-            // parsed reply.
+            // parsed reply.  The async state is reset below, so hand
+            // its fields over rather than copying them.
             if (async_events_.count(async_->event)) {
-              NotifyTorEvent(async_->event, async_->initial, async_->extra);
+              NotifyTorEvent(async_->event, std::move(async_->initial),
+                             std::move(async_->extra));
             }
           }
           async_.reset();
@@ -914,10 +923,10 @@ bool TorControl::ReadLine(const std::string& line) {
     // the queue.
     switch (pos) {
       case '-':
-        NotifyTorRawMid(status, reply);
+        NotifyTorRawMid(status.as_string(), reply.as_string());
         if (!cmdq_.empty()) {
           PerLineCallback& perline = cmdq_.front().first;
-          perline.Run(status, reply);
+          perline.Run(status.as_string(), reply.as_string());
         }
         return true;
       case '+':
@@ -925,11 +934,12 @@ bool TorControl::ReadLine(const std::string& line) {
         // XXX Just ignore it for now.
         return true;
       case ' ':
-        NotifyTorRawEnd(status, reply);
+        NotifyTorRawEnd(status.as_string(), reply.as_string());
         if (!cmdq_.empty()) {
           CmdCallback& callback = cmdq_.front().second;
           bool error = false;
-          std::move(callback).Run(error, status, reply);
+          std::move(callback).Run(error, status.as_string(),
+                                  reply.as_string());
           cmdq_.pop();
         }
         return true;
@@ -991,14 +1001,13 @@ void TorControl::NotifyTorControlClosed() {
       base::BindOnce(&Delegate::OnTorControlClosed, delegate_, running_));
 }
 
-void TorControl::NotifyTorEvent(
-    TorControlEvent event,
-    const std::string& initial,
-    const std::map<std::string, std::string>& extra) {
+void TorControl::NotifyTorEvent(TorControlEvent event,
+                                std::string initial,
+                                std::map<std::string, std::string> extra) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorEvent, delegate_, event, initial, extra));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorEvent, delegate_, event,
+                                std::move(initial), std::move(extra)));
 }
 
 void TorControl::NotifyTorRawCmd(const std::string& cmd) {
@@ -1038,7 +1047,7 @@ void TorControl::NotifyTorRawEnd(const std::string& status,
 //      success, false on failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value) {
   size_t end;
@@ -1053,21 +1062,21 @@ bool TorControl::ParseKV(const std::string& string,
 //      failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value,
                          size_t* end) {
   DCHECK(key && value && end);
   // Search for `=' -- it had better be there.
-  size_t eq = string.find("=");
-  if (eq == std::string::npos)
+  size_t eq = string.find('=');
+  if (eq == base::StringPiece::npos)
     return false;
   size_t vstart = eq + 1;
 
   // If we're at the end of the string, value is empt.
   if (vstart == string.size()) {
-    *key = string.substr(0, eq);
-    *value = "";
+    *key = string.substr(0, eq).as_string();
+    value->clear();
     *end = string.size();
     return true;
   }
@@ -1076,7 +1085,7 @@ bool TorControl::ParseKV(const std::string& string,
   if (string[vstart] != '"') {
     // Not quoted.  Check for a delimiter.
     size_t i, vend = string.size();
-    if ((i = string.find(" ", vstart)) != std::string::npos) {
+    if ((i = string.find(' ', vstart)) != base::StringPiece::npos) {
       // Delimited.  Stop at the delimiter, and consume it.
       vend = i;
       *end = vend + 1;
@@ -1086,19 +1095,19 @@ bool TorControl::ParseKV(const std::string& string,
     }
 
     // Check for internal quotes; they are forbidden.
-    if ((i = string.find("\"", vstart)) != std::string::npos)
+    if ((i = string.find('"', vstart)) != base::StringPiece::npos)
       return false;
 
     // Extract the key and value and we're done.
-    *key = string.substr(0, eq);
-    *value = string.substr(vstart, vend - vstart);
+    *key = string.substr(0, eq).as_string();
+    *value = string.substr(vstart, vend - vstart).as_string();
     return true;
   }
 
   // Quoted string.  Parse it, and consume trailing spaces.
   if (!ParseQuoted(string.substr(eq + 1), value, end))
     return false;
-  *key = string.substr(0, eq);
+  *key = string.substr(0, eq).as_string();
   *end += eq + 1;
   while (*end < string.size() && string[*end] == ' ')
     (*end)++;
@@ -1113,7 +1122,7 @@ bool TorControl::ParseKV(const std::string& string,
 //      return false on failure.
 //
 // static
-bool TorControl::ParseQuoted(const std::string& string,
+bool TorControl::ParseQuoted(base::StringPiece string,
                              std::string* value,
                              size_t* end) {
   enum {
@@ -1238,7 +1247,8 @@ bool TorControl::ParseQuoted(const std::string& string,
       case REJECT:
         return false;
       case ACCEPT:
-        *value = buf.substr(0, pos);
+        buf.resize(pos);
+        *value = std::move(buf);
         *end = i + 1;
         return true;
       default:
@@ -10,6 +10,7 @@
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/test/browser_task_environment.h"
+#include "net/base/io_buffer.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -184,6 +185,52 @@ TEST(TorControlTest, ReadLine) {
   base::RunLoop().RunUntilIdle();
 }
 
+TEST(TorControlTest, ReadDone) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  MockTorControlDelegate delegate;
+  std::unique_ptr<TorControl> control =
+      std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+
+  // Lines split across reads, including between CR and LF, are framed
+  // the same as lines delivered in one read.
+  EXPECT_CALL(delegate, OnTorRawMid("250", "SOCKSPORT=9050")).Times(1);
+  EXPECT_CALL(delegate, OnTorRawEnd("250", "OK")).Times(1);
+  EXPECT_CALL(delegate, OnTorControlClosed(false)).Times(1);
+  io_task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            auto feed = [&control](const std::string& chunk) {
+              memcpy(control->readiobuf_->data(), chunk.data(), chunk.size());
+              control->ReadDone(chunk.size());
+            };
+            control->reading_ = true;
+            control->readiobuf_ = base::MakeRefCounted<net::GrowableIOBuffer>();
+            control->readiobuf_->SetCapacity(4096);
+            control->read_start_ = 0;
+            control->read_cr_ = false;
+            control->async_events_[TorControlEvent::CIRC] = 1;
+
+            feed("250-SOCKS");
+            feed("PORT=9050\r");
+            EXPECT_TRUE(control->read_cr_);
+            feed("\n250 OK\r\n");
+            EXPECT_TRUE(control->reading_);
+            EXPECT_FALSE(control->read_cr_);
+            EXPECT_EQ(control->read_start_, control->readiobuf_->offset());
+
+            // A bare LF is rejected.
+            feed("250 OK\n");
+            EXPECT_FALSE(control->reading_);
+          },
+          std::move(control)));
+
+  base::RunLoop().RunUntilIdle();
+}
+
 TEST(TorControlTest, GetCircuitEstablishedDone) {
   content::BrowserTaskEnvironment task_environment;
   scoped_refptr<base::SequencedTaskRunner> io_task_runner =
@@ -7,17 +7,46 @@
 
 #include <utility>
 
+namespace {
+
+// Chunks of history or favicons which have been sent but not yet written by
+// the browser. Beyond this the importer waits, so that a large profile is not
+// queued up in the browser process.
+constexpr int kMaxPendingChunks = 2;
+
+}  // namespace
+
 BraveExternalProcessImporterBridge::BraveExternalProcessImporterBridge(
     const base::flat_map<uint32_t, std::string>& localized_strings,
     mojo::SharedRemote<chrome::mojom::ProfileImportObserver> observer,
     mojo::SharedRemote<brave::mojom::ProfileImportObserver> brave_observer)
     : ExternalProcessImporterBridge(std::move(localized_strings),
                                          std::move(observer)),
-      brave_observer_(std::move(brave_observer)) {}
+      brave_observer_(std::move(brave_observer)),
+      chunk_finished_(&lock_) {}
 
 BraveExternalProcessImporterBridge::
     ~BraveExternalProcessImporterBridge() = default;
 
+void BraveExternalProcessImporterBridge::SetHistoryItems(
+    const std::vector<ImporterURLRow>& rows,
+    importer::VisitSource visit_source) {
+  if (rows.empty())
+    return;
+
+  WaitForPendingChunks();
+  ExternalProcessImporterBridge::SetHistoryItems(rows, visit_source);
+}
+
+void BraveExternalProcessImporterBridge::SetFavicons(
+    const favicon_base::FaviconUsageDataList& favicons) {
+  if (favicons.empty())
+    return;
+
+  WaitForPendingChunks();
+  ExternalProcessImporterBridge::SetFavicons(favicons);
+}
+
 void BraveExternalProcessImporterBridge::SetCreditCard(
     const base::string16& name_on_card,
     const base::string16& expiration_month,
@@ -29,3 +58,23 @@ void BraveExternalProcessImporterBridge::SetCreditCard(
       expiration_year, decrypted_card_number,
       origin);
 }
+
+void BraveExternalProcessImporterBridge::OnImportChunkFinished() {
+  base::AutoLock auto_lock(lock_);
+  if (pending_chunks_ > 0)
+    pending_chunks_--;
+  chunk_finished_.Signal();
+}
+
+void BraveExternalProcessImporterBridge::Cancel() {
+  base::AutoLock auto_lock(lock_);
+  cancelled_ = true;
+  chunk_finished_.Signal();
+}
+
+void BraveExternalProcessImporterBridge::WaitForPendingChunks() {
+  base::AutoLock auto_lock(lock_);
+  while (!cancelled_ && pending_chunks_ >= kMaxPendingChunks)
+    chunk_finished_.Wait();
+  pending_chunks_++;
+}
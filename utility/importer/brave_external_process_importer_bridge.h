@@ -7,10 +7,15 @@
 #define BRAVE_UTILITY_IMPORTER_BRAVE_EXTERNAL_PROCESS_IMPORTER_BRIDGE_H_
 
 #include <string>
+#include <vector>
 
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "brave/common/importer/brave_importer_bridge.h"
 #include "brave/common/importer/profile_import.mojom.h"
+#include "chrome/common/importer/importer_url_row.h"
 #include "chrome/utility/importer/external_process_importer_bridge.h"
+#include "components/favicon_base/favicon_usage_data.h"
 
 class BraveExternalProcessImporterBridge : public ExternalProcessImporterBridge,
                                            public BraveImporterBridge {
@@ -25,16 +30,35 @@ class BraveExternalProcessImporterBridge : public ExternalProcessImporterBridge,
   BraveExternalProcessImporterBridge& operator=(
       const BraveExternalProcessImporterBridge&) = delete;
 
+  // ExternalProcessImporterBridge overrides. These block the import thread
+  // while too many chunks are waiting to be written by the browser.
+  void SetHistoryItems(const std::vector<ImporterURLRow>& rows,
+                       importer::VisitSource visit_source) override;
+  void SetFavicons(const favicon_base::FaviconUsageDataList& favicons) override;
+
   void SetCreditCard(const base::string16& name_on_card,
                      const base::string16& expiration_month,
                      const base::string16& expiration_year,
                      const base::string16& decrypted_card_number,
                      const std::string& origin) override;
 
+  // Called on the main thread when the browser has written a chunk.
+  void OnImportChunkFinished();
+
+  // Unblocks the import thread when the import is cancelled.
+  void Cancel();
+
  private:
   ~BraveExternalProcessImporterBridge() override;
 
+  void WaitForPendingChunks();
+
   mojo::SharedRemote<brave::mojom::ProfileImportObserver> brave_observer_;
+
+  base::Lock lock_;
+  base::ConditionVariable chunk_finished_;
+  int pending_chunks_ = 0;
+  bool cancelled_ = false;
 };
 
 #endif  // BRAVE_UTILITY_IMPORTER_BRAVE_EXTERNAL_PROCESS_IMPORTER_BRIDGE_H_
@@ -104,8 +104,17 @@ void BraveProfileImportImpl::ReportImportItemFinished(
   }
 }
 
+void BraveProfileImportImpl::ReportImportChunkFinished() {
+  if (bridge_)
+    bridge_->OnImportChunkFinished();
+}
+
 void BraveProfileImportImpl::ImporterCleanup() {
   importer_->Cancel();
+  // The import thread may be waiting for the browser to write a chunk, so
+  // unblock it before joining the thread.
+  if (bridge_)
+    bridge_->Cancel();
   importer_.reset();
   bridge_.reset();
   import_thread_.reset();
@@ -45,6 +45,7 @@ class BraveProfileImportImpl : public brave::mojom::ProfileImport {
       override;
   void CancelImport() override;
   void ReportImportItemFinished(importer::ImportItem item) override;
+  void ReportImportChunkFinished() override;
 
   void ImporterCleanup();
 
@@ -5,16 +5,21 @@
 
 #include "brave/utility/importer/chrome_importer.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "base/barrier_closure.h"
+#include "base/bind.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task/thread_pool.h"
 #include "base/values.h"
 #include "build/build_config.h"
 #include "brave/common/importer/scoped_copy_file.h"
@@ -51,6 +56,11 @@ using base::Time;
 
 namespace {
 
+// History rows and favicons are sent to the bridge in chunks of these sizes,
+// so that a large profile is never held in memory at once.
+constexpr size_t kHistoryRowsPerChunk = 1000;
+constexpr size_t kFaviconsPerChunk = 100;
+
 // Most of below code is copied from os_crypt_win.cc
 #if defined(OS_WIN)
 // Contains base64 random key encrypted with DPAPI.
@@ -174,6 +184,16 @@ bool PasswordFormToImportedPasswordForm(
   return true;
 }
 
+void ReencodeFaviconData(const std::vector<unsigned char>* image_data,
+                         std::vector<unsigned char>* png_data,
+                         base::OnceClosure done_callback) {
+  if (!importer::ReencodeFavicon(image_data->data(), image_data->size(),
+                                 png_data)) {
+    png_data->clear();  // Unable to decode.
+  }
+  std::move(done_callback).Run();
+}
+
 }  // namespace
 
 ChromeImporter::ChromeImporter() {
@@ -261,7 +281,11 @@ void ChromeImporter::ImportHistory() {
     row.typed_count = s.ColumnInt(3);
     row.visit_count = s.ColumnInt(4);
 
-    rows.push_back(row);
+    rows.push_back(std::move(row));
+    if (rows.size() == kHistoryRowsPerChunk) {
+      bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+      rows.clear();
+    }
   }
 
   if (!rows.empty() && !cancelled())
@@ -281,6 +305,8 @@ void ChromeImporter::ImportBookmarks() {
                          &bookmarks_content);
   base::Optional<base::Value> bookmarks_json =
     base::JSONReader::Read(bookmarks_content);
+  // The parsed bookmarks are all that is needed from here on.
+  std::string().swap(bookmarks_content);
   const base::DictionaryValue* bookmark_dict;
   if (!bookmarks_json || !bookmarks_json->GetAsDictionary(&bookmark_dict))
     return;
@@ -333,11 +359,8 @@ void ChromeImporter::ImportBookmarks() {
   FaviconMap favicon_map;
   ImportFaviconURLs(&db, &favicon_map);
   // Write favicons into profile.
-  if (!favicon_map.empty() && !cancelled()) {
-    favicon_base::FaviconUsageDataList favicons;
-    LoadFaviconData(&db, favicon_map, &favicons);
-    bridge_->SetFavicons(favicons);
-  }
+  if (!favicon_map.empty() && !cancelled())
+    LoadFaviconData(&db, favicon_map);
 }
 
 void ChromeImporter::ImportFaviconURLs(
@@ -355,8 +378,7 @@ void ChromeImporter::ImportFaviconURLs(
 
 void ChromeImporter::LoadFaviconData(
     sql::Database* db,
-    const FaviconMap& favicon_map,
-    favicon_base::FaviconUsageDataList* favicons) {
+    const FaviconMap& favicon_map) {
   const char query[] = "SELECT f.url, fb.image_data "
                        "FROM favicons f "
                        "JOIN favicon_bitmaps fb "
@@ -367,29 +389,75 @@ void ChromeImporter::LoadFaviconData(
   if (!s.is_valid())
     return;
 
+  favicon_base::FaviconUsageDataList favicons;
+  std::vector<std::vector<unsigned char>> image_data;
+
   for (FaviconMap::const_iterator i = favicon_map.begin();
-       i != favicon_map.end(); ++i) {
+       i != favicon_map.end() && !cancelled(); ++i) {
     s.BindInt64(0, i->first);
     if (s.Step()) {
       favicon_base::FaviconUsageData usage;
 
       usage.favicon_url = GURL(s.ColumnString(0));
-      if (!usage.favicon_url.is_valid())
+      if (!usage.favicon_url.is_valid()) {
+        s.Reset(true);
         continue;  // Don't bother importing favicons with invalid URLs.
+      }
 
       std::vector<unsigned char> data;
       s.ColumnBlobAsVector(1, &data);
-      if (data.empty())
+      if (data.empty()) {
+        s.Reset(true);
         continue;  // Data definitely invalid.
-
-      if (!importer::ReencodeFavicon(&data[0], data.size(), &usage.png_data))
-        continue;  // Unable to decode.
+      }
 
       usage.urls = i->second;
-      favicons->push_back(usage);
+      favicons.push_back(std::move(usage));
+      image_data.push_back(std::move(data));
+
+      if (favicons.size() == kFaviconsPerChunk)
+        SendFavicons(&favicons, &image_data);
     }
     s.Reset(true);
   }
+
+  SendFavicons(&favicons, &image_data);
+}
+
+void ChromeImporter::SendFavicons(
+    favicon_base::FaviconUsageDataList* favicons,
+    std::vector<std::vector<unsigned char>>* image_data) {
+  DCHECK_EQ(favicons->size(), image_data->size());
+  if (favicons->empty() || cancelled())
+    return;
+
+  // Decoding and encoding images dominates the import of favicons, so spread
+  // the chunk over the thread pool and wait for all of it.
+  base::WaitableEvent reencoded;
+  base::RepeatingClosure barrier = base::BarrierClosure(
+      favicons->size(), base::BindOnce(&base::WaitableEvent::Signal,
+                                       base::Unretained(&reencoded)));
+  for (size_t i = 0; i < favicons->size(); ++i) {
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindOnce(&ReencodeFaviconData,
+                       base::Unretained(&image_data->at(i)),
+                       base::Unretained(&favicons->at(i).png_data), barrier));
+  }
+  reencoded.Wait();
+
+  favicons->erase(
+      std::remove_if(favicons->begin(), favicons->end(),
+                     [](const favicon_base::FaviconUsageData& usage) {
+                       return usage.png_data.empty();
+                     }),
+      favicons->end());
+
+  if (!favicons->empty() && !cancelled())
+    bridge_->SetFavicons(*favicons);
+
+  favicons->clear();
+  image_data->clear();
 }
 
 void ChromeImporter::RecursiveReadBookmarksFolder(
@@ -62,10 +62,14 @@ class ChromeImporter : public Importer {
     sql::Database* db,
     FaviconMap* favicon_map);
 
-  // Loads and reencodes the individual favicons.
-  void LoadFaviconData(sql::Database* db,
-                       const FaviconMap& favicon_map,
-                       favicon_base::FaviconUsageDataList* favicons);
+  // Loads and reencodes the individual favicons, and sends them to the
+  // bridge in chunks.
+  void LoadFaviconData(sql::Database* db, const FaviconMap& favicon_map);
+
+  // Reencodes |image_data| into |favicons| on the thread pool, and sends the
+  // favicons which could be decoded to the bridge.
+  void SendFavicons(favicon_base::FaviconUsageDataList* favicons,
+                    std::vector<std::vector<unsigned char>>* image_data);
 
   void RecursiveReadBookmarksFolder(
     const base::DictionaryValue* folder,
@@ -12,6 +12,7 @@
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/test/task_environment.h"
 #include "brave/common/brave_paths.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/importer/imported_bookmark_entry.h"
@@ -62,6 +63,8 @@ class ChromeImporterTest : public ::testing::Test {
     bridge_ = new MockImporterBridge;
   }
 
+  // Favicons are reencoded on the thread pool.
+  base::test::TaskEnvironment task_environment_;
   base::ScopedTempDir temp_dir_;
   base::FilePath profile_dir_;
   importer::SourceProfile profile_;